@@ -7,7 +7,9 @@
 #include <plugin_api.h>
 #include <reading.h>
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -21,8 +23,11 @@
 
 #include "tase2_client_config.hpp"
 #include "tase2_client_connection.hpp"
+#include "tase2_ingest_queue.hpp"
+#include "tase2_tls_context.hpp"
+#include "tase2_update_window.hpp"
+#include "tase2_value_converter.hpp"
 
-#define BACKUP_CONNECTION_TIMEOUT 5000
 
 class TASE2Client;
 
@@ -30,6 +35,7 @@ class TASE2
 {
   public:
     using INGEST_CB = void (*) (void*, Reading);
+    using INGEST_CB2 = void (*) (void*, std::vector<Reading*>*);
 
     TASE2 () = default;
     ~TASE2 ();
@@ -49,8 +55,12 @@ class TASE2
     void ingest (const std::string& assetName,
                  const std::vector<Datapoint*>& points);
 
+    void ingest (std::vector<Reading*>* readings);
+
     void registerIngest (void* data, void (*cb) (void*, Reading));
 
+    void registerIngestV2 (void* data, INGEST_CB2 cb);
+
     bool operation (const std::string& operation, int count,
                     PLUGIN_PARAMETER** params);
 
@@ -61,11 +71,17 @@ class TASE2
     bool m_CommandOperation (int count, PLUGIN_PARAMETER** params);
     bool m_SetPointRealOperation (int count, PLUGIN_PARAMETER** params);
     bool m_SetPointDiscreteOperation (int count, PLUGIN_PARAMETER** params);
+    bool m_RefreshOperation (int count, PLUGIN_PARAMETER** params);
+    static void m_parseRefreshParameters (int count, PLUGIN_PARAMETER** params,
+                                          std::vector<std::string>& labels,
+                                          std::string& domain);
 
     std::string m_asset;
 
     INGEST_CB m_ingest
         = nullptr; // Callback function used to send data to south service
+    INGEST_CB2 m_ingestV2
+        = nullptr; // Callback function used to send reading batches
     void* m_data;  // Ingest function data
     TASE2Client* m_client = nullptr;
 
@@ -79,8 +95,51 @@ class TASE2Client
 
     ~TASE2Client ();
 
-    void sendData (const std::vector<Datapoint*>& data,
-                   const std::vector<std::string>& labels);
+    void sendData (std::vector<Reading*>* readings);
+
+    /* false when the report is ingested value by value, no endReport then */
+    bool beginReport ();
+    void endReport ();
+
+    /* pass an update to the ingest thread */
+    void queueUpdate (const PointUpdate& update);
+
+    /* read the points with the given labels, of a domain, or all points */
+    bool refresh (const std::vector<std::string>& labels,
+                  const std::string& domain);
+
+    void sendConnectionStatistics (const std::string& connection,
+                                   uint64_t connectAttempts,
+                                   uint64_t reconnects,
+                                   uint64_t timeToReconnect);
+
+    void sendPollStatistics (
+        const std::string& connection,
+        const std::vector<TASE2ClientConnection::PollCycleStats>& cycles);
+
+    size_t
+    ingestQueueHighWaterMark () const
+    {
+        return m_ingestQueue ? m_ingestQueue->highWaterMark () : 0;
+    };
+
+    uint64_t
+    ingestQueueDropped () const
+    {
+        return m_ingestQueue ? m_ingestQueue->dropped () : 0;
+    };
+
+    uint64_t
+    suppressedUpdates () const
+    {
+        return m_suppressedUpdates;
+    };
+
+    uint64_t
+    deadbandFilteredUpdates () const
+    {
+        return m_deadbandFilteredUpdates;
+    };
 
     void start ();
 
@@ -88,9 +147,18 @@ class TASE2Client
 
     void prepareConnections ();
 
-    void handleValue (std::string ref, Tase2_PointValue value,
-                      uint64_t timestamp, bool ack);
-    void handleAllValues ();
+    /* wakes the monitoring thread, called by the connections */
+    void connectionStateChanged ();
+
+    /* TLS credentials for a new endpoint, see TLSContextCache */
+    std::shared_ptr<TLSContext>
+    tlsContext ()
+    {
+        return m_tlsContexts.get ();
+    }
+
+    void handleValue (const char* domain, const char* name,
+                      Tase2_PointValue value, uint64_t timestamp, bool ack);
 
     bool handleOperation (Datapoint* operation);
 
@@ -115,6 +183,14 @@ class TASE2Client
     TASE2ClientConnection* m_active_connection = nullptr;
     std::mutex m_activeConnectionMtx;
 
+    // second association that does the polling (poll_on_standby)
+    TASE2ClientConnection* m_standby_connection = nullptr;
+    void m_superviseStandby ();
+    void m_activateStandby ();
+    void m_connectRedundancyGroup ();
+    void m_useConnection (TASE2ClientConnection* chosen);
+    void m_releaseStandby ();
+
     enum class ConnectionStatus
     {
         STARTED,
@@ -131,28 +207,67 @@ class TASE2Client
     std::thread* m_monitoringThread = nullptr;
     void _monitoringThread ();
 
+    std::mutex m_connectionStateMtx;
+    std::condition_variable m_connectionStateCond;
+    bool m_connectionStateEvent = false;
+    bool m_waitConnectionState (std::chrono::steady_clock::time_point until);
+
     bool m_started = false;
 
     TASE2ClientConfig* m_config;
     TASE2* m_tase2;
 
+    TLSContextCache m_tlsContexts;
+
     template <class T>
     Datapoint*
     m_createDatapoint (const std::string& label, const std::string& ref,
                        T value, Tase2_DataFlags quality, uint64_t timestampMs);
 
-    void m_handleMonitoringData (const std::string& objRef,
-                                 std::vector<Datapoint*>& datapoints,
-                                 const std::string& label, DPTYPE type,
+    void m_handleMonitoringData (const DataExchangeDefinition* def,
                                  Tase2_PointValue value, uint64_t timestamp);
 
-    Datapoint* m_createDataObject (Tase2_PointValue value,
-                                   const std::string& domain,
-                                   const std::string& name, uint64_t ts,
-                                   DPTYPE type);
+    Datapoint* m_createDataObject (const PointUpdate& update);
+    void m_addAggregate (Datapoint* dataObject, const AggregateStats& stats);
+
+    void m_queueValue (const DataExchangeDefinition* def,
+                       Tase2_PointValue value, uint64_t timestamp);
+    void m_queueUpdate (const PointUpdate& update, OverflowPolicy policy);
+    bool m_queueMarker (const PointUpdate& marker);
+    void m_wakeIngestThread ();
+    void m_queueReadings (std::vector<Reading*>* readings);
+    void m_sendQueuedReadings ();
+    void m_logIngestQueueMetrics ();
+    bool m_isFiltered (const PointUpdate& update);
 
     std::unordered_map<std::string, Datapoint*> m_outstandingCommands;
 
+    // decouples the libtase2 receive threads from the south service
+    IngestQueue<PointUpdate>* m_ingestQueue = nullptr;
+    std::thread* m_ingestThread = nullptr;
+    void _ingestThread ();
+
+    std::atomic<bool> m_ingestRunning{ false };
+    std::atomic<bool> m_ingestWaiting{ false };
+    std::mutex m_ingestMtx;
+    std::condition_variable m_ingestCond;
+
+    // statistics readings, sent by the ingest thread as well
+    std::mutex m_queuedReadingsMtx;
+    std::vector<Reading*> m_queuedReadings;
+    std::atomic<bool> m_readingsQueued{ false };
+
+    size_t m_reportedHighWaterMark = 0;
+    uint64_t m_reportedDropped = 0;
+    std::atomic<uint64_t> m_splitReports{ 0 }; // markers that did not fit
+    uint64_t m_reportedSplitReports = 0;
+
+    // indexed by PointId, only used by the ingest thread
+    std::vector<LastValue> m_lastValues;
+    std::atomic<uint64_t> m_suppressedUpdates{ 0 };
+    std::atomic<uint64_t> m_deadbandFilteredUpdates{ 0 };
+    UpdateWindows m_windows;
+
     FRIEND_TESTS
 };
 
@@ -0,0 +1,48 @@
+#ifndef TASE2_BACKOFF_H
+#define TASE2_BACKOFF_H
+
+#include <cstdint>
+#include <random>
+
+/*
+ * Delay before the next connection attempt. Starts at the initial delay and
+ * doubles with every failed attempt up to the maximum. Each delay is varied
+ * at random by up to +/- jitter (fraction of the delay), so that clients
+ * losing the same server do not all come back at the same moment.
+ *
+ * Not thread safe. Times are ms.
+ */
+class ReconnectBackoff
+{
+  public:
+    ReconnectBackoff (uint64_t initialDelay = 1000,
+                      uint64_t maxDelay = 10000, double jitter = 0.2);
+
+    void configure (uint64_t initialDelay, uint64_t maxDelay, double jitter);
+
+    /* delay after one more failed attempt */
+    uint64_t next ();
+
+    /* connected again, the next failure starts from the initial delay */
+    void
+    reset ()
+    {
+        m_failures = 0;
+    }
+
+    uint32_t
+    failures () const
+    {
+        return m_failures;
+    }
+
+  private:
+    uint64_t m_initialDelay;
+    uint64_t m_maxDelay;
+    double m_jitter;
+    uint32_t m_failures = 0;
+
+    std::mt19937 m_random;
+};
+
+#endif /* TASE2_BACKOFF_H */
@@ -4,6 +4,8 @@
 #include "libtase2/tase2_client.h"
 #include "rapidjson/document.h"
 #include "rapidjson/error/en.h"
+#include "tase2_ingest_queue.hpp"
+#include "tase2_point_index.hpp"
 #include "tase2_utility.hpp"
 #include <gtest/gtest.h>
 #include <logger.h>
@@ -17,10 +19,37 @@
     FRIEND_TEST (ConnectionHandlingTest, SingleConnectionTLS);                \
     FRIEND_TEST (ConnectionHandlingTest, SingleConnectionReconnect);          \
     FRIEND_TEST (ConnectionHandlingTest, TwoConnectionsBackup);               \
+    FRIEND_TEST (ConnectionHandlingTest, ConnectFailureBackoff);              \
+    FRIEND_TEST (ConnectionHandlingTest, StandbyPolling);                     \
+    FRIEND_TEST (ConnectionHandlingTest, ParallelDialPriority);               \
+    FRIEND_TEST (ConnectionHandlingTest, ParallelDialGraceWindow);            \
+    FRIEND_TEST (ConnectionHandlingTest, FailoverOnStateChange);              \
+    FRIEND_TEST (ConnectionHandlingTest, StatisticsFromIngestThread);         \
+    FRIEND_TEST (ConnectionHandlingTest, HotStandbyFailover);                 \
+    FRIEND_TEST (ConnectionHandlingTest, TLSCredentialReuse);                 \
     FRIEND_TEST (SpontDataTest, PollingAllType);                              \
+    FRIEND_TEST (SpontDataTest, PollingAllTypeBulk);                          \
+    FRIEND_TEST (SpontDataTest, PollingFollowsConnection);                    \
+    FRIEND_TEST (SpontDataTest, PollingOutstandingReads);                     \
+    FRIEND_TEST (SpontDataTest, Refresh);                                     \
+    FRIEND_TEST (SpontDataTest, RefreshParameters);                           \
     FRIEND_TEST (ControlTest, operateDirect);                                 \
     FRIEND_TEST (ReportingTest, ReportingAllType);                            \
     FRIEND_TEST (ReportingTest, ReportingAllTypeDynamicDataset);              \
+    FRIEND_TEST (ReportingTest, ReportingBatchedIngest);                      \
+    FRIEND_TEST (ReportingTest, DstsFallbackPolling);                         \
+    FRIEND_TEST (DataObjectTest, AllocationsPerValue);                        \
+    FRIEND_TEST (LastValueTest, SuppressUnchanged);                           \
+    FRIEND_TEST (LastValueTest, DstsOptions);                                 \
+    FRIEND_TEST (LastValueTest, Deadband);                                    \
+    FRIEND_TEST (LastValueTest, SourceTimestamp);                             \
+    FRIEND_TEST (PollScheduleTest, SpreadPhases);                             \
+    FRIEND_TEST (PollScheduleTest, BurstPhases);                              \
+    FRIEND_TEST (PollScheduleTest, CycleStatistics);                          \
+    FRIEND_TEST (PollScheduleTest, OverrunSkip);                              \
+    FRIEND_TEST (PollScheduleTest, OverrunCatchUp);                           \
+    FRIEND_TEST (PollScheduleTest, OverrunStretch);                           \
+    FRIEND_TEST (PollScheduleTest, AdaptiveBackoff);                          \
     FRIEND_TEST (ControlTest, operateSelect);
 
 typedef enum
@@ -80,11 +109,78 @@ struct RedGroup
     bool tls;
 };
 
+struct ValueConverter;
+
+enum class CoalesceMode
+{
+    LATEST,    // ingest the last update of a window
+    FIRST_LAST // ingest the first update right away and the last one
+};
+
+enum class PollSchedule
+{
+    BURST, // read all units of an interval back to back
+    SPREAD // spread the units of an interval evenly over the interval
+};
+
+/* back off the polling of values that don't change */
+struct AdaptivePolling
+{
+    bool enabled = false;
+    int unchangedPolls = 3;      // polls without change before backing off
+    double factor = 2.0;         // interval growth per back off
+    uint64_t maxInterval = 60000; // ms
+};
+
+/* what to do when a poll unit is due again before its read finished */
+enum class OverrunPolicy
+{
+    SKIP,     // drop the missed cycles and keep the phase
+    CATCH_UP, // read again right away
+    STRETCH   // lengthen the interval until the reads fit
+};
+
+/* dense index of an exchanged point, assigned in import order */
+using PointId = uint32_t;
+
 struct DataExchangeDefinition
 {
+    PointId id;
     std::string ref;
     DPTYPE type;
     std::string label;
+
+    // constant parts of the data_object, precomputed at import
+    std::string domain;
+    std::string name;
+    std::string typeName;
+
+    const ValueConverter* converter = nullptr;
+
+    // monitoring point that is not part of a dataset
+    bool polled = false;
+
+    // ms, 0: the polling_interval of the application layer
+    uint64_t pollingInterval = 0;
+    std::string pollGroup;
+
+    // drop updates with the same value and quality as the last one, but
+    // still ingest one every heartbeat ms (0: never)
+    bool suppressUnchanged = false;
+    bool suppressUnchangedSet = false; // configured on the point
+    uint64_t heartbeat = 0;
+
+    // Real types only: drop updates closer than the deadband to the last
+    // ingested value, either absolute or in percent of that value
+    double deadband = 0.0;
+    bool deadbandPercent = false;
+
+    // ms, updates within the window are coalesced (0: off)
+    uint64_t coalesceWindow = 0;
+    CoalesceMode coalesceMode = CoalesceMode::LATEST;
+
+    // ms, Real types only: one reading with statistics per window (0: off)
+    uint64_t aggregateWindow = 0;
 };
 
 struct DatasetTransferSet
@@ -101,6 +197,8 @@ struct DatasetTransferSet
     bool critical;
     bool rbe;
     bool allChangesReported;
+    bool suppressUnchanged = false; // applied to the points of the dataset
+    int heartbeat = 0;              // s
 };
 
 struct Dataset
@@ -109,12 +207,13 @@ struct Dataset
     std::string datasetRef;
     std::vector<std::string> entries;
     bool dynamic;
+    std::vector<PointId> points; // exchanged points among the entries
 };
 
 class TASE2ClientConfig
 {
   public:
-    TASE2ClientConfig () { m_exchangeDefinitions.clear (); };
+    TASE2ClientConfig () = default;
     ~TASE2ClientConfig ();
 
     int
@@ -142,6 +241,13 @@ class TASE2ClientConfig
                                       const uint8_t selectorSize);
     void importExchangeConfig (const std::string& exchangeConfig);
     void importTlsConfig (const std::string& tlsConfig);
+    void importDeadband (const rapidjson::Value& protocol,
+                         DataExchangeDefinition& def);
+    void importCoalesce (const rapidjson::Value& protocol,
+                         DataExchangeDefinition& def);
+    void importAggregate (const rapidjson::Value& protocol,
+                          DataExchangeDefinition& def);
+    void importAdaptivePolling (const rapidjson::Value& adaptive);
 
     static std::pair<std::string, std::string>
     splitExchangeRef (std::string ref);
@@ -176,20 +282,33 @@ class TASE2ClientConfig
 
     static int getCdcTypeFromString (const std::string& cdc);
 
-    std::unordered_map<std::string, std::shared_ptr<DataExchangeDefinition> >&
-    ExchangeDefinition ()
+    const std::vector<DataExchangeDefinition>&
+    ExchangeDefinition () const
     {
         return m_exchangeDefinitions;
     };
 
+    const DataExchangeDefinition&
+    getExchangeDefinition (PointId id) const
+    {
+        return m_exchangeDefinitions[id];
+    };
+
     static int GetTypeIdByName (const std::string& name);
 
     std::string* checkExchangeDataLayer (int typeId, std::string& objRef);
 
-    std::shared_ptr<DataExchangeDefinition>
-    getExchangeDefinitionByLabel (const std::string& label);
-    std::shared_ptr<DataExchangeDefinition>
-    getExchangeDefinitionByRef (const std::string& objRef);
+    const DataExchangeDefinition*
+    getExchangeDefinitionByLabel (const std::string& label) const;
+    const DataExchangeDefinition*
+    getExchangeDefinitionByRef (const std::string& objRef) const;
+
+    /* lookup for the report path, without building the reference */
+    const DataExchangeDefinition*
+    findExchangeDefinition (const char* domain, const char* name) const
+    {
+        return m_exchangeDefinitionsIndex.find (domain, name);
+    };
 
     const std::unordered_map<std::string,
                              std::shared_ptr<DatasetTransferSet> >&
@@ -202,8 +321,7 @@ class TASE2ClientConfig
     {
         return m_datasets;
     };
-    const std::unordered_map<std::string,
-                             std::shared_ptr<DataExchangeDefinition> >&
+    const std::vector<PointId>&
     polledDatapoints () const
     {
         return m_polledDatapoints;
@@ -215,12 +333,159 @@ class TASE2ClientConfig
         return pollingInterval;
     }
 
+    /* polling interval of a point in ms, 0 when it is not polled */
+    uint64_t
+    getPollingInterval (const DataExchangeDefinition& def) const
+    {
+        return def.pollingInterval ? def.pollingInterval
+                                   : (uint64_t)pollingInterval;
+    }
+
     uint64_t
     backupConnectionTimeout ()
     {
         return m_backupConnectionTimeout;
     };
 
+    uint64_t
+    connectGraceWindow () const
+    {
+        return m_connectGraceWindow;
+    };
+
+    bool
+    hotStandby () const
+    {
+        return m_hotStandby;
+    };
+
+    uint64_t
+    connectTimeout () const
+    {
+        return m_connectTimeout;
+    };
+
+    uint64_t
+    reconnectDelay () const
+    {
+        return m_reconnectDelay;
+    };
+
+    uint64_t
+    maxReconnectDelay () const
+    {
+        return m_maxReconnectDelay;
+    };
+
+    double
+    reconnectJitter () const
+    {
+        return m_reconnectJitter;
+    };
+
+    size_t
+    ingestQueueSize () const
+    {
+        return m_ingestQueueSize;
+    };
+
+    OverflowPolicy
+    ingestOverflowPolicy () const
+    {
+        return m_ingestOverflowPolicy;
+    };
+
+    bool
+    bulkPolling () const
+    {
+        return m_bulkPolling;
+    };
+
+    size_t
+    maxPduSize () const
+    {
+        return m_maxPduSize;
+    };
+
+    size_t
+    maxDataSetMembers () const
+    {
+        return m_maxDataSetMembers;
+    };
+
+    PollSchedule
+    pollSchedule () const
+    {
+        return m_pollSchedule;
+    };
+
+    int
+    maxPollReads () const
+    {
+        return m_maxPollReads;
+    };
+
+    OverrunPolicy
+    overrunPolicy () const
+    {
+        return m_overrunPolicy;
+    };
+
+    const AdaptivePolling&
+    adaptivePolling () const
+    {
+        return m_adaptivePolling;
+    };
+
+    int
+    maxOutstandingReads () const
+    {
+        return m_maxOutstandingReads;
+    };
+
+    uint64_t
+    refreshTtl () const
+    {
+        return m_refreshTtl;
+    };
+
+    /* interval used to poll the points of a DSTS that doesn't report, 0 to
+     * not poll them */
+    uint64_t
+    fallbackPollingInterval () const
+    {
+        return m_fallbackPollingInterval;
+    };
+
+    uint64_t
+    dstsRetryInterval () const
+    {
+        return m_dstsRetryInterval;
+    };
+
+    bool
+    pollOnStandby () const
+    {
+        return m_pollOnStandby;
+    };
+
+    /* points of the dataset of a DSTS */
+    const std::vector<PointId>& dstsPoints (
+        const DatasetTransferSet& dsts) const;
+
+    /* asset of the polling statistics readings, empty when disabled */
+    const std::string&
+    statisticsAsset () const
+    {
+        return m_statisticsAsset;
+    };
+
+    uint64_t
+    statisticsPeriod () const
+    {
+        return m_statisticsPeriod;
+    };
+
   private:
     static bool isMessageTypeMatching (int expectedType, int rcvdType);
 
@@ -228,13 +493,21 @@ class TASE2ClientConfig
 
     void deleteExchangeDefinitions ();
 
-    std::unordered_map<std::string, std::shared_ptr<DataExchangeDefinition> >
-        m_polledDatapoints;
+    void m_parseExchangeConfig (const std::string& exchangeConfig);
+    void m_updatePolledDatapoints ();
+    void m_resolveDatasetPoints ();
+    void m_applyDstsPointOptions ();
+    void m_applyPollGroups (
+        const std::unordered_map<std::string, uint64_t>& pollGroups);
+
+    // ids of the points not covered by a dataset, polled one by one
+    std::vector<PointId> m_polledDatapoints;
     std::unordered_map<std::string, std::shared_ptr<Dataset> > m_datasets;
-    std::unordered_map<std::string, std::shared_ptr<DataExchangeDefinition> >
-        m_exchangeDefinitions;
-    std::unordered_map<std::string, std::shared_ptr<DataExchangeDefinition> >
-        m_exchangeDefinitionsRef;
+    // indexed by PointId, not resized after import so pointers stay valid
+    std::vector<DataExchangeDefinition> m_exchangeDefinitions;
+    std::unordered_map<std::string, PointId> m_exchangeDefinitionsLabel;
+    std::unordered_map<std::string, PointId> m_exchangeDefinitionsRef;
+    PointIndex<DataExchangeDefinition> m_exchangeDefinitionsIndex;
 
     std::unordered_map<std::string, std::shared_ptr<DatasetTransferSet> >
         m_dsTranferSets;
@@ -249,8 +522,52 @@ class TASE2ClientConfig
 
     uint64_t m_backupConnectionTimeout = 5000;
 
+    // how long a connected server waits for one of higher priority
+    uint64_t m_connectGraceWindow = 1000;
+
+    // keep the other servers associated with their DSTS armed
+    bool m_hotStandby = false;
+
+    uint64_t m_connectTimeout = 10000;
+    // backoff between connect attempts, doubles up to the maximum
+    uint64_t m_reconnectDelay = 1000;
+    uint64_t m_maxReconnectDelay = 10000;
+    double m_reconnectJitter = 0.2; // +/- fraction of the delay
+
     long pollingInterval = 0;
 
+    size_t m_ingestQueueSize = 65536;
+    OverflowPolicy m_ingestOverflowPolicy = OverflowPolicy::DROP_NEWEST;
+
+    // poll through transient datasets, read in PDUs of at most this size.
+    // Off by default, the server has to allow the client to create datasets
+    bool m_bulkPolling = false;
+    size_t m_maxPduSize = 65000;
+    size_t m_maxDataSetMembers = 100; // members the server accepts per dataset
+
+    PollSchedule m_pollSchedule = PollSchedule::BURST;
+    // due units read per pass of the poll thread, the rest waits for the
+    // next pass. Also caps the reads of a refresh pass. 0 for no limit
+    int m_maxPollReads = 0;
+    OverrunPolicy m_overrunPolicy = OverrunPolicy::SKIP;
+    AdaptivePolling m_adaptivePolling;
+
+    // poll reads in flight at the same time on one association
+    int m_maxOutstandingReads = 1;
+
+    // a refresh is served from a read that is at most this old (ms)
+    uint64_t m_refreshTtl = 1000;
+
+    // points of a failed DSTS are polled until it reports again (ms)
+    uint64_t m_fallbackPollingInterval = 10000;
+    uint64_t m_dstsRetryInterval = 60000;
+
+    // poll over a second association, the active one only gets the reports
+    bool m_pollOnStandby = false;
+
+    std::string m_statisticsAsset;
+    uint64_t m_statisticsPeriod = 60000; // ms
+
     FRIEND_TESTS
 };
 
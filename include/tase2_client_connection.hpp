@@ -2,10 +2,17 @@
 #define TASE2_CLIENT_CONNECTION_H
 
 #include "datapoint.h"
+#include "tase2_backoff.hpp"
 #include "tase2_client_config.hpp"
+#include "tase2_timing_wheel.hpp"
+#include "tase2_tls_context.hpp"
+#include "tase2_value_converter.hpp"
 #include <gtest/gtest.h>
 #include <libtase2/tase2_client.h>
 #include <libtase2/tase2_common.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <thread>
 
@@ -22,9 +29,23 @@ class TASE2ClientConnection
 
     void Start ();
     void Stop ();
+
+    /* use the association: set up datasets, DSTS and polling. Until then a
+     * connected connection only holds the association open. */
     void Activate ();
 
+    /* hot standby: create the datasets and DSTS on the association but
+     * leave the DSTS disabled, Activate only has to enable them */
+    void Arm ();
+
+    bool
+    Armed () const
+    {
+        return m_associationArmed;
+    };
+
     void Disconnect ();
+    void GiveUp ();
     void Connect ();
 
     bool
@@ -54,6 +75,64 @@ class TASE2ClientConnection
     Tase2_PointValue readValue (Tase2_ClientError* err, const char* domain,
                                 const char* name);
 
+    /* read the given points as soon as possible, done by the poll thread */
+    bool refresh (const std::vector<PointId>& points);
+
+    /* a connection that only polls, the DSTS are set up by the active one.
+     * Takes effect when the connection is activated. */
+    void
+    setPollingOnly (bool pollingOnly)
+    {
+        m_pollingOnly = pollingOnly;
+    };
+
+    /* pause the scheduled polling while another connection polls, the
+     * fallback polling of DSTS points goes on */
+    void setPollingSuspended (bool suspended);
+
+    /* read time and slack of the poll cycles of one polling interval */
+    struct PollCycleStats
+    {
+        uint64_t interval = 0;
+        uint64_t effectiveInterval = 0; // longer than interval when stretched
+        uint64_t cycles = 0;            // completed cycles
+        uint64_t overruns = 0; // reads that were due again when they ended
+        uint64_t duration = 0; // read time of the last cycle (ms)
+        int64_t slack = 0;     // interval minus duration
+        uint64_t points = 0;   // points read in the last cycle
+        uint64_t maxDuration = 0; // longest read time of a cycle
+        uint64_t maxLateness = 0; // longest delay of a read past its due time
+
+        uint64_t cycleStart = 0;
+        uint64_t busy = 0; // read time of the running cycle
+        uint64_t pointsRead = 0;
+
+        // read times of the last cycles, for the percentiles
+        std::vector<uint64_t> durations;
+        size_t nextDuration = 0;
+
+        /* read time of a cycle below which p percent of the last cycles are */
+        uint64_t
+        durationPercentile (int p) const
+        {
+            if (durations.empty ())
+                return 0;
+
+            std::vector<uint64_t> sorted (durations);
+            size_t n = (sorted.size () - 1) * p / 100;
+
+            std::nth_element (sorted.begin (), sorted.begin () + n,
+                              sorted.end ());
+            return sorted[n];
+        }
+    };
+
+    const std::vector<PollCycleStats>&
+    pollCycleStats () const
+    {
+        return m_pollCycles;
+    };
+
     bool operate (const std::string& ref, DatapointValue value);
 
     const std::string&
@@ -85,7 +164,6 @@ class TASE2ClientConnection
     };
 
     Tase2_Endpoint m_endpoint = nullptr;
-    void executePeriodicTasks ();
 
     void cleanUp ();
 
@@ -130,10 +208,140 @@ class TASE2ClientConnection
         m_connControlPairs;
 
     std::vector<Tase2_ClientDataSet> m_datasets;
-    std::vector<Tase2_ClientDSTransferSet> m_dsts;
+    // runtime state of a configured DSTS
+    struct DstsState
+    {
+        std::shared_ptr<DatasetTransferSet> config;
+        Tase2_ClientDSTransferSet ts = nullptr; // nullptr while not set up
+        uint64_t nextRetry = 0;                 // of the set up
+        uint64_t lastReport = 0;
+        bool fallback = false; // its points are polled
+        bool enabled = true;   // false while armed on a hot standby
+    };
+
+    std::mutex m_dstsLock;
+    std::vector<DstsState> m_dstsStates;
+    std::atomic<bool> m_fallbackChanged{ false };
+
+    // fallback poll units per entry of m_dstsStates, owned by the poll thread
+    std::vector<std::vector<uint32_t> > m_fallbackUnits;
+    std::vector<bool> m_fallbackActive;
+
+    Tase2_ClientDSTransferSet m_startDsts (const DatasetTransferSet& config,
+                                           bool enabled);
+    void m_enableDsts ();
+    void m_superviseDsts ();
+    void m_dstsReported (Tase2_ClientDSTransferSet transferSet);
+    void m_applyDstsFallback ();
+
+    // what is read at once when polling: a transient dataset with the
+    // points of a domain and polling interval, or a single point
+    struct PollUnit
+    {
+        std::string domain;
+        std::string name;
+        std::vector<PointId> points;
+        Tase2_ClientDataSet dataSet = nullptr;
+        uint64_t interval = 0;
+        uint64_t due = 0;
+        size_t cycle = 0; // index in m_pollCycles
+        bool active = true;     // false for the units of a reporting DSTS
+        bool scheduled = false; // in the wheel or due
+        bool fallback = false;  // polls the points of a DSTS
+
+        // adaptive polling
+        uint64_t fingerprint = 0; // of the values of the last read
+        bool hasFingerprint = false;
+        int unchangedPolls = 0;
+        uint64_t backoffInterval = 0; // 0 when polled at its own interval
+    };
+
+    std::vector<PollUnit> m_pollUnits;
+    std::string m_pollDataSetPrefix;
+    int m_pollDataSetCount = 0;
+    static std::string pollDataSetPrefix ();
+    TimingWheel m_pollWheel;
+    std::vector<uint32_t> m_duePollUnits; // due, oldest first
+    std::vector<PollCycleStats> m_pollCycles;
+
+    // last value read per point, refresh requests are served from it
+    struct PolledValue
+    {
+        PointUpdate update;
+        uint64_t readTime = 0; // monotonic ms
+        bool valid = false;
+    };
+
+    std::vector<PolledValue> m_polledValues; // indexed by PointId
+    std::vector<int> m_unitOfPoint; // poll unit of a point, -1 if none
+
+    // points to refresh with the time of the request
+    std::mutex m_refreshLock;
+    std::vector<std::pair<PointId, uint64_t> > m_refreshRequests;
+
+    void m_handleRefreshRequests ();
+
+    // guards the poll units, held by the poll thread for a whole pass
+    std::mutex m_pollLock;
+    std::condition_variable m_pollCond;
+    std::atomic<bool> m_pollingEnabled{ false };
+    std::atomic<bool> m_pollingOnly{ false };
+    std::atomic<bool> m_pollingSuspended{ false };
+    std::atomic<bool> m_resumePolling{ false };
+    uint64_t m_nextStatisticsTime = 0;
+
+    std::thread* m_pollThread = nullptr;
+    void _pollThread ();
+
+    // read of a poll unit handed to the read workers, so that up to
+    // max_outstanding_reads requests are in flight on the association
+    struct PollJob
+    {
+        uint32_t index;
+        bool done = false;
+        uint64_t start = 0;
+        uint64_t end = 0;
+        uint64_t fingerprint = 0;
+    };
+
+    std::vector<PollJob> m_pollJobs;
+    size_t m_nextPollJob = 0;
+    size_t m_pendingPollJobs = 0;
+    uint64_t m_pollJobTimestamp = 0;
+    bool m_readWorkersRunning = false;
+    std::mutex m_readLock;
+    std::condition_variable m_readCond;
+    std::condition_variable m_readDoneCond;
+    std::vector<std::thread*> m_readWorkers;
+
+    void _readWorker ();
+    void m_runPollJobs (uint64_t timestamp);
+    void m_workPollJobs (std::unique_lock<std::mutex>& lock);
 
     void m_initialiseControlObjects ();
+    bool m_createDataSet (const std::string& domain, const std::string& name,
+                          const std::vector<std::string>& entries);
     void m_configDatasets ();
+    void m_configPollUnits ();
+    void m_addPollUnits (const std::vector<PointId>& points,
+                         uint64_t pollingInterval);
+    void m_addSinglePollUnit (PointId id, uint64_t interval);
+    void m_deletePollUnits ();
+    const PointUpdate& m_emitPolledValue (PointId id, Tase2_PointValue value,
+                                          uint64_t timestamp);
+    bool m_pollPoint (PointId id, uint64_t timestamp, uint64_t* fingerprint);
+    uint64_t m_pollUnit (const PollUnit& unit, uint64_t timestamp);
+    void m_adaptPollUnit (PollUnit& unit, uint64_t fingerprint);
+    void m_schedulePollUnits (size_t first);
+    void m_pollDueUnits ();
+    void m_resumePollUnits ();
+    void m_updatePollCycle (const PollUnit& unit, uint64_t start,
+                            uint64_t end);
+    void m_reschedulePollUnit (uint32_t index, uint64_t end);
+    void m_sendPollStatistics (uint64_t now);
+    static void endpointStateChangedHandler (Tase2_Endpoint endpoint,
+                                             void* parameter,
+                                             Tase2_Endpoint_State newState);
     static void
     dsTransferSetReportHandler (void* parameter, bool finished, uint32_t seq,
                                 Tase2_ClientDSTransferSet transferSet);
@@ -142,33 +350,56 @@ class TASE2ClientConnection
                                Tase2_ClientDSTransferSet transferSet,
                                const char* domainName, const char* pointName,
                                Tase2_PointValue pointValue);
-    void m_configDsts ();
+    void m_configDsts (bool enabled);
+    void m_setupAssociation ();
+    void m_armAssociation ();
     void m_setVarSpecs ();
     void m_setOsiConnectionParameters ();
 
     OsiParameters* m_osiParameters;
     int m_tcpPort;
     std::string m_serverIp;
-    bool m_connected = false;
-    bool m_active = false;
-    bool m_connecting = false;
+    std::atomic<bool> m_connected{ false };
+    std::atomic<bool> m_active{ false };
+    bool m_associationReady = false; // m_setupAssociation done
+    std::atomic<bool> m_armed{ false };
+    std::atomic<bool> m_associationArmed{ false }; // m_armAssociation done
+    std::atomic<bool> m_connecting{ false };
     bool m_started = false;
     bool m_useTls = false;
     bool m_passive = false;
 
-    TLSConfiguration m_tlsConfig = nullptr;
+    std::shared_ptr<TLSContext> m_tlsContext; // used by m_endpoint
 
     std::mutex m_conLock;
     std::mutex m_reportLock;
 
     uint64_t m_delayExpirationTime;
 
-    uint64_t m_nextPollingTime = 0;
+    // reconnect backoff, owned by the connection thread
+    ReconnectBackoff m_backoff;
+    uint64_t m_nextConnectTime = 0;
+    uint64_t m_disconnectedSince = 0; // 0 while connected
+    uint64_t m_connectAttempts = 0;
+    uint64_t m_reconnects = 0;
+    void m_connectFailed ();
+    void m_connectSucceeded ();
+    void m_closeConnection ();
 
     std::thread* m_conThread = nullptr;
     void _conThread ();
 
-    bool m_connect = false;
+    // wakes the connection thread on endpoint state changes and requests
+    std::mutex m_conWaitLock;
+    std::condition_variable m_conCond;
+    bool m_conEvent = false;
+    void m_signalConThread ();
+    void m_waitConThread ();
+
+    // the DSTS report being received has its markers queued, receive thread
+    bool m_reportBatched = false;
+
+    std::atomic<bool> m_connect{ false };
     bool m_disconnect = false;
 
     void sendActCon (const ControlObjectStruct* cos);
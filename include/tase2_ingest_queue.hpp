@@ -0,0 +1,389 @@
+#ifndef TASE2_INGEST_QUEUE_H
+#define TASE2_INGEST_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Behaviour of IngestQueue::push when the ring buffer is full
+ */
+enum class OverflowPolicy
+{
+    DROP_NEWEST, // discard the update that is being pushed
+    DROP_OLDEST, // discard the oldest queued update to make room
+    BLOCK        // wait until the consumer has made room (not for callbacks
+                 // of the stack, it holds up the receive thread)
+};
+
+/*
+ * Whether DROP_OLDEST may discard a queued item. Specialize for item types
+ * that carry markers which must always reach the consumer.
+ */
+template <class T> struct EvictionTraits
+{
+    static bool
+    evictable (const T&)
+    {
+        return true;
+    }
+};
+
+/*
+ * Bounded lock-free ring buffer used between the libtase2 callbacks
+ * (producers) and the ingest thread (consumer).
+ *
+ * Based on the sequence-numbered cell design by Dmitry Vyukov: every cell
+ * carries a sequence number telling producers and consumers whether it is
+ * free or holds data for the current lap, so no locks are needed and
+ * several producers can push concurrently.
+ *
+ * DROP_OLDEST pops from the producer side. Poppers are serialized by a
+ * spin lock, so that items which are not evictable can be taken off the
+ * ring and kept in front of it without changing the order seen by the
+ * consumer.
+ *
+ * reserve slots are kept free for tryPushReserved, so that items like report
+ * markers still fit when the ring is full of ordinary ones.
+ */
+template <class T> class IngestQueue
+{
+  public:
+    explicit IngestQueue (size_t capacity, size_t reserve = 0)
+    {
+        size_t size = 2;
+
+        while (size < capacity + reserve)
+            size <<= 1;
+
+        m_mask = size - 1;
+        m_limit = size - reserve;
+        m_cells = std::vector<Cell> (size);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            m_cells[i].sequence.store (i, std::memory_order_relaxed);
+        }
+    }
+
+    IngestQueue (const IngestQueue&) = delete;
+    IngestQueue& operator= (const IngestQueue&) = delete;
+
+    bool
+    tryPush (const T& item)
+    {
+        if (m_limit <= m_mask && m_ringSize () >= m_limit)
+            return false;
+
+        return m_ringPush (item);
+    }
+
+    /* push into the reserved slots as well. Never waits. */
+    bool
+    tryPushReserved (const T& item)
+    {
+        return m_ringPush (item);
+    }
+
+    bool
+    tryPop (T& item)
+    {
+        bool popped = m_pop (item);
+
+        if (popped)
+        {
+            // pairs with the fence in m_waitForRoom
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+
+            if (m_blocked.load (std::memory_order_relaxed) > 0)
+            {
+                std::lock_guard<std::mutex> lock (m_roomLock);
+                m_roomCond.notify_all ();
+            }
+        }
+
+        return popped;
+    }
+
+    /*
+     * Push an item applying the given overflow policy.
+     *
+     * Returns false when an update had to be discarded (either the new one
+     * or the oldest queued one).
+     */
+    bool
+    push (const T& item, OverflowPolicy policy)
+    {
+        if (tryPush (item))
+            return true;
+
+        m_overflows.fetch_add (1, std::memory_order_relaxed);
+
+        switch (policy)
+        {
+        case OverflowPolicy::DROP_OLDEST:
+            while (!tryPush (item))
+            {
+                m_evictOldest ();
+            }
+            return false;
+        case OverflowPolicy::BLOCK:
+            m_waitForRoom (item);
+            return true;
+        case OverflowPolicy::DROP_NEWEST:
+        default:
+            m_dropped.fetch_add (1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    /* approximate number of queued items */
+    size_t
+    size () const
+    {
+        return m_ringSize () + m_frontSize.load (std::memory_order_relaxed);
+    }
+
+    bool
+    empty () const
+    {
+        return size () == 0;
+    }
+
+    /* items that fit without the reserve */
+    size_t
+    capacity () const
+    {
+        return m_limit;
+    }
+
+    size_t
+    highWaterMark () const
+    {
+        return m_highWaterMark.load (std::memory_order_relaxed);
+    }
+
+    uint64_t
+    dropped () const
+    {
+        return m_dropped.load (std::memory_order_relaxed);
+    }
+
+    uint64_t
+    overflows () const
+    {
+        return m_overflows.load (std::memory_order_relaxed);
+    }
+
+  private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+
+        Cell () : sequence (0) {}
+        Cell (const Cell& other)
+            : sequence (other.sequence.load (std::memory_order_relaxed)),
+              data (other.data)
+        {
+        }
+    };
+
+    size_t
+    m_ringSize () const
+    {
+        size_t enq = m_enqueuePos.load (std::memory_order_relaxed);
+        size_t deq = m_dequeuePos.load (std::memory_order_relaxed);
+
+        return enq > deq ? enq - deq : 0;
+    }
+
+    /* sleep until the consumer has made room. The timeout only covers a
+     * wake up that is missed between the check and the wait. */
+    void
+    m_waitForRoom (const T& item)
+    {
+        std::unique_lock<std::mutex> lock (m_roomLock);
+
+        m_blocked.fetch_add (1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+
+        while (!tryPush (item))
+        {
+            m_roomCond.wait_for (lock, std::chrono::milliseconds (10));
+        }
+
+        m_blocked.fetch_sub (1, std::memory_order_relaxed);
+    }
+
+    bool
+    m_ringPush (const T& item)
+    {
+        Cell* cell;
+        size_t pos = m_enqueuePos.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->sequence.load (std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak (
+                        pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load (std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = item;
+        cell->sequence.store (pos + 1, std::memory_order_release);
+
+        updateHighWaterMark ();
+
+        return true;
+    }
+
+    bool
+    m_pop (T& item)
+    {
+        PopLock lock (m_popLock);
+
+        if (!m_front.empty ())
+        {
+            item = m_front.front ();
+            m_front.pop_front ();
+            m_frontSize.fetch_sub (1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return m_ringPop (item);
+    }
+
+    void
+    updateHighWaterMark ()
+    {
+        size_t current = size ();
+        size_t hwm = m_highWaterMark.load (std::memory_order_relaxed);
+
+        while (current > hwm
+               && !m_highWaterMark.compare_exchange_weak (
+                   hwm, current, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    class PopLock
+    {
+      public:
+        explicit PopLock (std::atomic_flag& flag) : m_flag (flag)
+        {
+            while (m_flag.test_and_set (std::memory_order_acquire))
+                std::this_thread::yield ();
+        }
+
+        ~PopLock () { m_flag.clear (std::memory_order_release); }
+
+      private:
+        std::atomic_flag& m_flag;
+    };
+
+    /* drop the oldest evictable item. Older items that may not be dropped
+     * move in front of the ring, they stay the oldest ones. */
+    void
+    m_evictOldest ()
+    {
+        PopLock lock (m_popLock);
+        T oldest;
+
+        while (m_ringPop (oldest))
+        {
+            if (EvictionTraits<T>::evictable (oldest))
+            {
+                m_dropped.fetch_add (1, std::memory_order_relaxed);
+                return;
+            }
+
+            m_front.push_back (oldest);
+            m_frontSize.fetch_add (1, std::memory_order_relaxed);
+        }
+    }
+
+    /* pop from the ring, called with m_popLock held */
+    bool
+    m_ringPop (T& item)
+    {
+        Cell* cell;
+        size_t pos = m_dequeuePos.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->sequence.load (std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+            if (diff == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak (
+                        pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_dequeuePos.load (std::memory_order_relaxed);
+            }
+        }
+
+        item = cell->data;
+        cell->sequence.store (pos + m_mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // keep producer and consumer positions on separate cache lines
+    static constexpr size_t PADDING = 64 - sizeof (std::atomic<size_t>);
+
+    std::vector<Cell> m_cells;
+    size_t m_mask = 0;
+    size_t m_limit = 0; // ordinary items, the rest of the ring is reserved
+
+    char m_pad0[PADDING];
+    std::atomic<size_t> m_enqueuePos{ 0 };
+    char m_pad1[PADDING];
+    std::atomic<size_t> m_dequeuePos{ 0 };
+    char m_pad2[PADDING];
+
+    std::atomic<size_t> m_highWaterMark{ 0 };
+    std::atomic<uint64_t> m_dropped{ 0 };
+    std::atomic<uint64_t> m_overflows{ 0 };
+
+    // items taken off the ring by an eviction that may not be dropped
+    std::atomic_flag m_popLock = ATOMIC_FLAG_INIT;
+    std::deque<T> m_front;
+    std::atomic<size_t> m_frontSize{ 0 };
+
+    // producers waiting with OverflowPolicy::BLOCK
+    std::atomic<int> m_blocked{ 0 };
+    std::mutex m_roomLock;
+    std::condition_variable m_roomCond;
+};
+
+#endif /* TASE2_INGEST_QUEUE_H */
@@ -0,0 +1,129 @@
+#ifndef TASE2_POINT_INDEX_H
+#define TASE2_POINT_INDEX_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*
+ * Open addressing hash index of data points keyed by the (domain, name)
+ * pair that libtase2 hands to the report callbacks.
+ *
+ * Lookups take the two C strings as they are, so no "domain:name" string
+ * has to be built per received value. The hash of every entry is computed
+ * once on insert and compared before the names are.
+ *
+ * T must have std::string members domain and name. Entries are not owned.
+ */
+template <class T> class PointIndex
+{
+  public:
+    /* FNV-1a over domain ':' name, the same as hashing the reference */
+    static uint64_t
+    hash (const char* domain, const char* name)
+    {
+        uint64_t h = FNV_OFFSET;
+
+        for (const char* c = domain; *c; c++)
+            h = (h ^ (uint8_t)*c) * FNV_PRIME;
+
+        h = (h ^ (uint8_t)':') * FNV_PRIME;
+
+        for (const char* c = name; *c; c++)
+            h = (h ^ (uint8_t)*c) * FNV_PRIME;
+
+        return h;
+    }
+
+    /* add an entry, replacing an existing one with the same domain and name */
+    void
+    insert (const T* entry)
+    {
+        if ((m_count + 1) * 2 > m_slots.size ())
+            grow ();
+
+        uint64_t h = hash (entry->domain.c_str (), entry->name.c_str ());
+        Slot* slot = probe (entry->domain.c_str (), entry->name.c_str (), h);
+
+        if (slot->entry == nullptr)
+            m_count++;
+
+        slot->hash = h;
+        slot->entry = entry;
+    }
+
+    const T*
+    find (const char* domain, const char* name) const
+    {
+        if (m_count == 0)
+            return nullptr;
+
+        return probe (domain, name, hash (domain, name))->entry;
+    }
+
+    void
+    clear ()
+    {
+        m_slots.clear ();
+        m_count = 0;
+    }
+
+    size_t
+    size () const
+    {
+        return m_count;
+    }
+
+  private:
+    static constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+    struct Slot
+    {
+        uint64_t hash = 0;
+        const T* entry = nullptr;
+    };
+
+    /* slot holding the key, or the empty slot where it would go */
+    Slot*
+    probe (const char* domain, const char* name, uint64_t h) const
+    {
+        size_t mask = m_slots.size () - 1;
+        size_t i = h & mask;
+
+        for (;;)
+        {
+            Slot* slot = const_cast<Slot*> (&m_slots[i]);
+
+            if (slot->entry == nullptr
+                || (slot->hash == h && slot->entry->domain == domain
+                    && slot->entry->name == name))
+            {
+                return slot;
+            }
+
+            i = (i + 1) & mask;
+        }
+    }
+
+    void
+    grow ()
+    {
+        std::vector<Slot> old;
+        old.swap (m_slots);
+
+        m_slots.resize (old.empty () ? 16 : old.size () * 2);
+        m_count = 0;
+
+        for (const Slot& slot : old)
+        {
+            if (slot.entry)
+                insert (slot.entry);
+        }
+    }
+
+    std::vector<Slot> m_slots;
+    size_t m_count = 0;
+};
+
+#endif /* TASE2_POINT_INDEX_H */
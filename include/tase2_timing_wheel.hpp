@@ -0,0 +1,60 @@
+#ifndef TASE2_TIMING_WHEEL_H
+#define TASE2_TIMING_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Hierarchical timing wheel for the polling schedule of a connection.
+ *
+ * Four levels of 64 slots. Level 0 has one slot per tick, every higher
+ * level 64 times coarser slots whose timers are moved down a level when
+ * the lower level wraps around. Scheduling and expiring are O(1) per
+ * timer, independent of the number of timers and intervals in use.
+ *
+ * Timers are identified by a caller chosen id. Times are ms.
+ */
+class TimingWheel
+{
+  public:
+    explicit TimingWheel (uint64_t tickMs = 10);
+
+    /* remove all timers and start counting ticks at now */
+    void reset (uint64_t now);
+
+    /* add a timer that expires at due (ms) */
+    void schedule (uint32_t id, uint64_t due);
+
+    /* move the wheel to now, ids of the expired timers are added to expired */
+    void advance (uint64_t now, std::vector<uint32_t>& expired);
+
+    size_t
+    size () const
+    {
+        return m_size;
+    }
+
+  private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const uint64_t SLOTS = 1 << SLOT_BITS;
+    static const uint64_t SLOT_MASK = SLOTS - 1;
+
+    struct Timer
+    {
+        uint32_t id;
+        uint64_t due; // in ticks
+    };
+
+    void m_insert (const Timer& timer);
+    void m_cascade (int level);
+
+    uint64_t m_tickMs;
+    uint64_t m_currentTick = 0;
+    size_t m_size = 0;
+
+    std::vector<Timer> m_slots[LEVELS][SLOTS];
+};
+
+#endif /* TASE2_TIMING_WHEEL_H */
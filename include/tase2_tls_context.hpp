@@ -0,0 +1,77 @@
+#ifndef TASE2_TLS_CONTEXT_H
+#define TASE2_TLS_CONTEXT_H
+
+#include "tase2_client_config.hpp"
+#include <libtase2/tase2_common.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/* TLS configuration with the credentials loaded, shared by the endpoints that
+ * use it and destroyed with the last of them. Not changed once created. */
+class TLSContext
+{
+  public:
+    explicit TLSContext (TLSConfiguration tlsConfig) : m_tlsConfig (tlsConfig)
+    {
+    }
+
+    ~TLSContext () { TLSConfiguration_destroy (m_tlsConfig); }
+
+    TLSContext (const TLSContext&) = delete;
+    TLSContext& operator= (const TLSContext&) = delete;
+
+    TLSConfiguration
+    get () const
+    {
+        return m_tlsConfig;
+    }
+
+  private:
+    TLSConfiguration m_tlsConfig;
+};
+
+/*
+ * Loads the key and certificates of the TLS configuration once for all
+ * connections and reconnects. The files are only read again when one of
+ * them changed (mtime, size or inode) or a missing one appeared.
+ *
+ * Loading is deferred to the first connect, the certificate store is found
+ * through FLEDGE_DATA at that time. Thread safe.
+ */
+class TLSContextCache
+{
+  public:
+    explicit TLSContextCache (TASE2ClientConfig* config)
+        : m_config (config)
+    {
+    }
+
+    /* context for a new endpoint, nullptr when the configuration failed */
+    std::shared_ptr<TLSContext> get ();
+
+  private:
+    struct File
+    {
+        std::string path;
+        bool exists = false;
+        time_t mtime = 0;
+        off_t size = 0;
+        ino_t inode = 0;
+    };
+
+    static File m_stat (const std::string& path);
+    bool m_changed () const;
+    std::shared_ptr<TLSContext> m_load ();
+
+    TASE2ClientConfig* m_config;
+
+    std::mutex m_lock;
+    std::shared_ptr<TLSContext> m_context;
+    std::vector<File> m_files; // read for m_context
+};
+
+#endif /* TASE2_TLS_CONTEXT_H */
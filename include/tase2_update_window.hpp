@@ -0,0 +1,105 @@
+#ifndef TASE2_UPDATE_WINDOW_H
+#define TASE2_UPDATE_WINDOW_H
+
+#include "tase2_client_config.hpp"
+#include "tase2_value_converter.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/*
+ * Running statistics of the values of an aggregation window
+ */
+struct AggregateStats
+{
+    double min = 0.0;
+    double max = 0.0;
+    double sum = 0.0;
+    uint64_t count = 0;
+
+    void
+    add (double value)
+    {
+        if (count == 0 || value < min)
+            min = value;
+        if (count == 0 || value > max)
+            max = value;
+        sum += value;
+        count++;
+    }
+};
+
+/* update to ingest, with the statistics when it closes an aggregation */
+struct WindowedUpdate
+{
+    PointUpdate update;
+    bool aggregate = false;
+    AggregateStats stats;
+
+    WindowedUpdate () = default;
+    WindowedUpdate (const PointUpdate& update) : update (update) {}
+};
+
+/*
+ * Per point time windows applied by the ingest thread before readings are
+ * created. Updates of a point with a coalescing window are held back and
+ * only the latest one (or the first and the last one) of a window is
+ * passed on. Points with an aggregation window only produce one update per
+ * window, the last one together with min, max, mean and count.
+ *
+ * Not thread safe, owned by the ingest thread. Times are monotonic ms.
+ */
+class UpdateWindows
+{
+  public:
+    using Output = std::vector<WindowedUpdate>;
+
+    /* drop all state and size the tables for the given number of points */
+    void reset (size_t points);
+
+    /* handle an update, updates that have to be ingested now go to out */
+    void add (const PointUpdate& update, uint64_t now, Output& out);
+
+    /* close the windows that ended at or before now */
+    void expire (uint64_t now, Output& out);
+
+    /* close all open windows, used on shutdown */
+    void flush (Output& out);
+
+    /* end of the next window to close, 0 when no window is open */
+    uint64_t
+    nextDeadline () const
+    {
+        return m_deadlines.empty () ? 0 : m_deadlines.top ().first;
+    }
+
+  private:
+    struct Window
+    {
+        bool open = false;
+        bool hasPending = false;
+        uint64_t deadline = 0;
+        PointUpdate pending;
+        Tase2_DataFlags flags = 0; // quality of the last update seen
+        AggregateStats stats;
+    };
+
+    void m_open (Window& window, PointId id, uint64_t duration, uint64_t now);
+    void m_close (Window& window, Output& out);
+    void m_coalesce (Window& window, const PointUpdate& update, uint64_t now,
+                     Output& out);
+    void m_aggregate (Window& window, const PointUpdate& update, uint64_t now,
+                      Output& out);
+
+    std::vector<Window> m_windows; // indexed by PointId
+
+    typedef std::pair<uint64_t, PointId> Deadline;
+    std::priority_queue<Deadline, std::vector<Deadline>,
+                        std::greater<Deadline> >
+        m_deadlines;
+};
+
+#endif /* TASE2_UPDATE_WINDOW_H */
@@ -0,0 +1,85 @@
+#ifndef TASE2_VALUE_CONVERTER_H
+#define TASE2_VALUE_CONVERTER_H
+
+#include "datapoint.h"
+#include "tase2_client_config.hpp"
+#include "tase2_ingest_queue.hpp"
+#include <cstdint>
+#include <libtase2/tase2_common.h>
+
+/*
+ * Compact copy of a received point value. The libtase2 callbacks queue these
+ * and the ingest thread turns them into readings.
+ */
+struct PointUpdate
+{
+    enum class Kind : uint8_t
+    {
+        VALUE,
+        REPORT_BEGIN,
+        REPORT_END
+    };
+
+    Kind kind = Kind::VALUE;
+    const DataExchangeDefinition* def = nullptr;
+    double realValue = 0.0;
+    int64_t intValue = 0;
+    Tase2_DataFlags flags = 0;
+    uint64_t timestamp = 0;       // time of reception
+    uint64_t sourceTimestamp = 0; // of the value, 0 for types without one
+};
+
+/* report markers are never dropped, the batch boundaries depend on them */
+template <> struct EvictionTraits<PointUpdate>
+{
+    static bool
+    evictable (const PointUpdate& update)
+    {
+        return update.kind == PointUpdate::Kind::VALUE;
+    }
+};
+
+/*
+ * Last value ingested for a point, kept by the ingest thread to detect
+ * updates that carry nothing new.
+ */
+struct LastValue
+{
+    bool valid = false;
+    double realValue = 0.0;
+    int64_t intValue = 0;
+    Tase2_DataFlags flags = 0;
+    uint64_t timestamp = 0; // of the last update, source time if it has one
+    uint64_t emitted = 0;   // of the last update ingested
+    double emittedValue = 0.0; // real value of the last update ingested
+
+    bool
+    sameAs (const PointUpdate& update) const
+    {
+        return valid && realValue == update.realValue
+               && intValue == update.intValue && flags == update.flags;
+    }
+};
+
+/*
+ * Type specific handling of a point value. There is one converter per
+ * DPTYPE, generated from DpTypeTraits, and every DataExchangeDefinition
+ * points to its converter so no per value dispatch is needed.
+ */
+struct ValueConverter
+{
+    const char* typeName;
+    bool isReal;
+    bool hasQuality;
+    bool hasTimestamp;
+
+    /* copy value and quality out of a libtase2 point value */
+    void (*extract) (Tase2_PointValue value, PointUpdate& update);
+
+    /* build the data_object datapoint for a queued update */
+    Datapoint* (*createDataObject) (const PointUpdate& update);
+};
+
+const ValueConverter* getValueConverter (DPTYPE type);
+
+#endif /* TASE2_VALUE_CONVERTER_H */
@@ -10,7 +10,7 @@
 
 using namespace std;
 
-typedef void (*INGEST_CB) (void*, Reading);
+typedef void (*INGEST_CB2) (void*, std::vector<Reading*>*);
 
 #define PLUGIN_NAME "tase2"
 
@@ -102,7 +102,7 @@ extern "C"
         VERSION,               // Version (automaticly generated by mkversion)
         SP_ASYNC | SP_CONTROL, // Flags - added control
         PLUGIN_TYPE_SOUTH,     // Type
-        "1.0.0",               // Interface version
+        "2.0.0",               // Interface version (multi-reading ingest)
         default_config         // Default configuration
     };
 
@@ -164,19 +164,19 @@ extern "C"
      * Register ingest callback
      */
     void
-    plugin_register_ingest (PLUGIN_HANDLE* handle, INGEST_CB cb, void* data)
+    plugin_register_ingest (PLUGIN_HANDLE* handle, INGEST_CB2 cb, void* data)
     {
         if (!handle)
             throw exception ();
 
         auto* tase2 = reinterpret_cast<TASE2*> (handle);
-        tase2->registerIngest (data, cb);
+        tase2->registerIngestV2 (data, cb);
     }
 
     /**
      * Poll for a plugin reading
      */
-    Reading
+    std::vector<Reading*>*
     plugin_poll (PLUGIN_HANDLE* handle)
     {
         throw runtime_error (
@@ -1,5 +1,7 @@
 #include "tase2.hpp"
 
+#include <sstream>
+
 TASE2::~TASE2 ()
 {
     stop ();
@@ -71,10 +73,35 @@ void
 TASE2::ingest (const std::string& assetName,
                const std::vector<Datapoint*>& points)
 {
-    if (m_ingest)
+    auto readings = new std::vector<Reading*>;
+    readings->push_back (new Reading (assetName, points));
+    ingest (readings);
+}
+
+/*
+ * Hand a batch of readings to the south service. Ownership of the vector and
+ * of the readings is transferred: with the multi-reading callback the service
+ * frees them, otherwise they are delivered one by one and freed here.
+ */
+void
+TASE2::ingest (std::vector<Reading*>* readings)
+{
+    if (m_ingestV2)
     {
-        m_ingest (m_data, Reading (assetName, points));
+        m_ingestV2 (m_data, readings);
+        return;
+    }
+
+    for (Reading* reading : *readings)
+    {
+        if (m_ingest)
+        {
+            m_ingest (m_data, *reading);
+        }
+        delete reading;
     }
+
+    delete readings;
 }
 
 void
@@ -84,6 +111,13 @@ TASE2::registerIngest (void* data, void (*cb) (void*, Reading))
     m_data = data;
 }
 
+void
+TASE2::registerIngestV2 (void* data, INGEST_CB2 cb)
+{
+    m_ingestV2 = cb;
+    m_data = data;
+}
+
 enum CommandParameters
 {
     TYPE,
@@ -208,6 +242,62 @@ TASE2::m_SetPointDiscreteOperation (int count, PLUGIN_PARAMETER** params)
     }
 }
 
+static std::string
+unquote (const std::string& value)
+{
+    if (value.size () >= 2 && value.front () == '"' && value.back () == '"')
+    {
+        return value.substr (1, value.length () - 2);
+    }
+
+    return value;
+}
+
+/* parameters "labels" (comma separated, each label may be quoted) or
+ * "domain". No labels, or an empty list, is all points */
+void
+TASE2::m_parseRefreshParameters (int count, PLUGIN_PARAMETER** params,
+                                 std::vector<std::string>& labels,
+                                 std::string& domain)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (params[i]->name == "labels")
+        {
+            std::stringstream stream (params[i]->value);
+            std::string label;
+
+            // quotes around the list end up on its first and last label
+            while (std::getline (stream, label, ','))
+            {
+                label.erase (0, label.find_first_not_of (" \t\""));
+                label.erase (label.find_last_not_of (" \t\"") + 1);
+
+                if (!label.empty ())
+                    labels.push_back (label);
+            }
+        }
+        else if (params[i]->name == "domain")
+        {
+            domain = unquote (params[i]->value);
+        }
+    }
+}
+
+bool
+TASE2::m_RefreshOperation (int count, PLUGIN_PARAMETER** params)
+{
+    std::vector<std::string> labels;
+    std::string domain;
+
+    m_parseRefreshParameters (count, params, labels, domain);
+
+    Tase2Utility::log_debug ("operate: refresh - %lu labels, domain: %s",
+                             (unsigned long)labels.size (), domain.c_str ());
+
+    return m_client->refresh (labels, domain);
+}
+
 bool
 TASE2::operation (const std::string& operation, int count,
                   PLUGIN_PARAMETER** params)
@@ -244,6 +334,11 @@ TASE2::operation (const std::string& operation, int count,
         }
     }
 
+    if (operation == "TASE2Refresh")
+    {
+        return m_RefreshOperation (count, params);
+    }
+
     Tase2Utility::log_error ("Unrecognised operation %s", operation.c_str ());
 
     return false;
@@ -0,0 +1,44 @@
+#include "tase2_backoff.hpp"
+
+#include <algorithm>
+
+ReconnectBackoff::ReconnectBackoff (uint64_t initialDelay, uint64_t maxDelay,
+                                    double jitter)
+    : m_random (std::random_device () ())
+{
+    configure (initialDelay, maxDelay, jitter);
+}
+
+void
+ReconnectBackoff::configure (uint64_t initialDelay, uint64_t maxDelay,
+                             double jitter)
+{
+    m_initialDelay = initialDelay;
+    m_maxDelay = std::max (initialDelay, maxDelay);
+    m_jitter = std::min (std::max (jitter, 0.0), 1.0);
+}
+
+uint64_t
+ReconnectBackoff::next ()
+{
+    uint64_t delay = m_initialDelay;
+
+    // stop doubling once the maximum is reached, avoids the overflow
+    for (uint32_t i = 0; i < m_failures && delay < m_maxDelay; i++)
+    {
+        delay *= 2;
+    }
+
+    delay = std::min (delay, m_maxDelay);
+
+    if (m_failures < UINT32_MAX)
+        m_failures++;
+
+    if (m_jitter > 0.0)
+    {
+        std::uniform_real_distribution<double> spread (-m_jitter, m_jitter);
+        delay = (uint64_t)((double)delay * (1.0 + spread (m_random)));
+    }
+
+    return delay;
+}
@@ -1,6 +1,8 @@
 #include "datapoint.h"
 #include "tase2_client_config.hpp"
 #include "tase2_client_connection.hpp"
+#include <algorithm>
+#include <cmath>
 #include <libtase2/hal_thread.h>
 #include <libtase2/tase2_client.h>
 #include <libtase2/tase2_common.h>
@@ -22,18 +24,6 @@ getMonotonicTimeInMs ()
     return timeVal;
 }
 
-static bool
-hasQuality (DPTYPE type)
-{
-    return type % 4 != 0 && type < COMMAND;
-}
-
-static bool
-hasTimestamp (DPTYPE type)
-{
-    return type % 4 >= 2 && type < COMMAND;
-}
-
 static uint64_t
 GetCurrentTimeInMs ()
 {
@@ -67,14 +57,6 @@ createDpWithValue (const std::string& name, const T value)
     return dp;
 }
 
-template <class T>
-static Datapoint*
-createDatapoint (const std::string& dataname, const T value)
-{
-    DatapointValue dp_value = DatapointValue (value);
-    return new Datapoint (dataname, dp_value);
-}
-
 static Datapoint*
 addElement (Datapoint* dp, const std::string& name)
 {
@@ -110,35 +92,9 @@ addElementWithValue (Datapoint* dp, const std::string& name, const T value)
     return element;
 }
 
-const static std::unordered_map<DPTYPE, std::string> DpTypeMap
-    = { { STATE, "State" },
-        { STATEQ, "StateQ" },
-        { STATEQTIME, "StateQTime" },
-        { STATEQTIMEEXT, "StateQTimeExt" },
-        { REAL, "Real" },
-        { REALQ, "RealQ" },
-        { REALQTIME, "RealQTime" },
-        { REALQTIMEEXT, "RealQTimeExt" },
-        { DISCRETE, "Discrete" },
-        { DISCRETEQ, "DiscreteQ" },
-        { DISCRETEQTIME, "DiscreteQTime" },
-        { DISCRETEQTIMEEXT, "DiscreteQTimeExt" },
-        { STATESUP, "StateSup" },
-        { STATESUPQ, "StateSupQ" },
-        { STATESUPQTIME, "StateSupQTime" },
-        { STATESUPQTIMEEXT, "StateSupQTimeExt" },
-        { COMMAND, "Command" },
-        { SETPOINTREAL, "SetPointReal" },
-        { SETPOINTDISCRETE, "SetPointDiscrete" } };
-
-static std::string
-dpTypeToStr (DPTYPE type)
-{
-    return DpTypeMap.at (type);
-}
-
 TASE2Client::TASE2Client (TASE2* tase2, TASE2ClientConfig* tase2_client_config)
-    : m_config (tase2_client_config), m_tase2 (tase2)
+    : m_config (tase2_client_config), m_tase2 (tase2),
+      m_tlsContexts (tase2_client_config)
 {
 }
 
@@ -153,6 +109,7 @@ TASE2Client::stop ()
     }
 
     m_started = false;
+    connectionStateChanged ();
 
     if (m_monitoringThread != nullptr)
     {
@@ -160,14 +117,58 @@ TASE2Client::stop ()
         delete m_monitoringThread;
         m_monitoringThread = nullptr;
     }
+
+    // all connections are gone now, let the ingest thread drain the queue
+    if (m_ingestThread != nullptr)
+    {
+        {
+            std::lock_guard<std::mutex> lock (m_ingestMtx);
+            m_ingestRunning = false;
+            m_ingestCond.notify_one ();
+        }
+        m_ingestThread->join ();
+        delete m_ingestThread;
+        m_ingestThread = nullptr;
+    }
+
+    m_logIngestQueueMetrics ();
+
+    if (m_suppressedUpdates > 0)
+    {
+        Tase2Utility::log_info ("%lu unchanged updates suppressed",
+                                (unsigned long)m_suppressedUpdates);
+    }
+
+    if (m_deadbandFilteredUpdates > 0)
+    {
+        Tase2Utility::log_info ("%lu updates within deadband dropped",
+                                (unsigned long)m_deadbandFilteredUpdates);
+    }
+
+    delete m_ingestQueue;
+    m_ingestQueue = nullptr;
 }
 
+/* ingest queue slots kept for the report markers, a report begins and ends
+ * in these even when the values fill the queue */
+static const size_t REPORT_MARKER_RESERVE = 256;
+
 void
 TASE2Client::start ()
 {
     if (m_started)
         return;
 
+    m_ingestQueue = new IngestQueue<PointUpdate> (m_config->ingestQueueSize (),
+                                                  REPORT_MARKER_RESERVE);
+    m_reportedHighWaterMark = 0;
+    m_reportedDropped = 0;
+    m_reportedSplitReports = 0;
+    m_lastValues.assign (m_config->ExchangeDefinition ().size (), LastValue ());
+    m_windows.reset (m_config->ExchangeDefinition ().size ());
+    m_ingestRunning = true;
+    m_ingestThread = new std::thread (&TASE2Client::_ingestThread, this);
+
     prepareConnections ();
     m_started = true;
     m_monitoringThread
@@ -194,6 +195,10 @@ TASE2Client::prepareConnections ()
     }
 }
 
+/* the monitoring thread is woken by connection state changes, this is only
+ * the period of retrying when no connection could be opened */
+static const std::chrono::milliseconds MONITORING_PERIOD (1000);
+
 void
 TASE2Client::updateConnectionStatus (ConnectionStatus newState)
 {
@@ -204,6 +209,31 @@ TASE2Client::updateConnectionStatus (ConnectionStatus newState)
     m_connStatus = newState;
 }
 
+void
+TASE2Client::connectionStateChanged ()
+{
+    {
+        std::lock_guard<std::mutex> lock (m_connectionStateMtx);
+        m_connectionStateEvent = true;
+    }
+    m_connectionStateCond.notify_all ();
+}
+
+/* wait for a connection state change, false when until passed without one */
+bool
+TASE2Client::m_waitConnectionState (
+    std::chrono::steady_clock::time_point until)
+{
+    std::unique_lock<std::mutex> lock (m_connectionStateMtx);
+
+    bool changed = m_connectionStateCond.wait_until (
+        lock, until, [this] () { return m_connectionStateEvent || !m_started; });
+
+    m_connectionStateEvent = false;
+
+    return changed;
+}
+
 void
 TASE2Client::_monitoringThread ()
 {
@@ -218,70 +248,240 @@ TASE2Client::_monitoringThread ()
 
     updateConnectionStatus (ConnectionStatus::NOT_CONNECTED);
 
-    uint64_t backupConnectionStartTime
-        = Hal_getTimeInMs () + BACKUP_CONNECTION_TIMEOUT;
-
     while (m_started)
     {
-        std::lock_guard<std::mutex> lock (m_activeConnectionMtx);
+        std::unique_lock<std::mutex> lock (m_activeConnectionMtx);
+
+        // the association of the active connection was lost
+        if (m_active_connection == nullptr || !m_active_connection->Active ())
+        {
+            m_releaseStandby ();
+            m_active_connection = nullptr;
 
-        if (m_active_connection == nullptr
-            || m_active_connection->Disconnected ())
+            // commands and refreshes fail fast instead of waiting for the dial
+            lock.unlock ();
+
+            m_connectRedundancyGroup ();
+        }
+        else
         {
-            bool foundOpenConnections = false;
-            for (auto clientConnection : *m_connections)
+            if (m_config->pollOnStandby ())
             {
-                backupConnectionStartTime
-                    = Hal_getTimeInMs () + BACKUP_CONNECTION_TIMEOUT;
+                m_superviseStandby ();
+            }
 
-                foundOpenConnections = true;
+            lock.unlock ();
+        }
 
-                clientConnection->Connect ();
+        m_waitConnectionState (std::chrono::steady_clock::now ()
+                               + MONITORING_PERIOD);
+    }
 
-                m_active_connection = clientConnection;
+    for (auto& clientConnection : *m_connections)
+    {
+        std::lock_guard<std::mutex> lock (m_activeConnectionMtx);
+        delete clientConnection;
+    }
 
-                Tase2Utility::log_debug ("Trying connection %s:%d",
-                                         clientConnection->IP ().c_str (),
-                                         clientConnection->Port ());
+    m_connections->clear ();
+}
 
-                auto start = std::chrono::high_resolution_clock::now ();
-                auto timeout = std::chrono::milliseconds (
-                    m_config->backupConnectionTimeout ());
+/* dial all servers of the redundancy group at once. The first one to
+ * connect becomes the active connection, unless a server of higher
+ * priority (earlier in the configuration) connects within the grace
+ * window. With poll_on_standby another connected server is kept as the
+ * standby, the others are closed. Called without m_activeConnectionMtx,
+ * only the monitoring thread changes the active connection.
+ */
+void
+TASE2Client::m_connectRedundancyGroup ()
+{
+    // failover to an armed hot standby, it only has to enable its DSTS
+    if (m_config->hotStandby ())
+    {
+        for (auto clientConnection : *m_connections)
+        {
+            if (clientConnection->Connected () && clientConnection->Armed ()
+                && !clientConnection->Active ())
+            {
+                m_useConnection (clientConnection);
+                return;
+            }
+        }
+    }
 
-                while (!clientConnection->Connected ())
-                {
-                    auto now = std::chrono::high_resolution_clock::now ();
-                    if (now - start > timeout)
-                    {
-                        clientConnection->Disconnect ();
-                        m_active_connection = nullptr;
-                        break;
-                    }
-                    Thread_sleep (10);
-                }
+    for (auto clientConnection : *m_connections)
+    {
+        Tase2Utility::log_debug ("Trying connection %s:%d",
+                                 clientConnection->IP ().c_str (),
+                                 clientConnection->Port ());
 
-                if (m_active_connection)
-                {
-                    break;
-                }
+        clientConnection->setPollingOnly (false);
+        clientConnection->setPollingSuspended (false);
+        clientConnection->Connect ();
+    }
+
+    auto now = std::chrono::steady_clock::now ();
+    auto deadline
+        = now + std::chrono::milliseconds (m_config->backupConnectionTimeout ());
+    auto graceEnd = deadline;
+    bool graceStarted = false;
+
+    TASE2ClientConnection* chosen = nullptr;
+
+    while (m_started)
+    {
+        // best connected server, and whether a better one is still trying
+        TASE2ClientConnection* best = nullptr;
+        bool betterPending = false;
+
+        for (auto clientConnection : *m_connections)
+        {
+            if (clientConnection->Connected ())
+            {
+                best = clientConnection;
+                break;
             }
+
+            if (clientConnection->Connecting ())
+                betterPending = true;
+        }
+
+        now = std::chrono::steady_clock::now ();
+
+        if (best && !graceStarted)
+        {
+            graceStarted = true;
+            graceEnd = std::min (deadline,
+                                 now
+                                     + std::chrono::milliseconds (
+                                         m_config->connectGraceWindow ()));
+        }
+
+        if (best && (!betterPending || now >= graceEnd))
+        {
+            chosen = best;
+            break;
+        }
+
+        if (now >= deadline)
+            break;
+
+        m_waitConnectionState (graceStarted ? graceEnd : deadline);
+    }
+
+    if (chosen == nullptr)
+    {
+        for (auto clientConnection : *m_connections)
+        {
+            clientConnection->GiveUp ();
+        }
+        return;
+    }
+
+    m_useConnection (chosen);
+}
+
+/* make chosen the active connection. The others become the polling standby
+ * (poll_on_standby), are armed as hot standby (hotStandby) or are closed.
+ * Called without m_activeConnectionMtx. */
+void
+TASE2Client::m_useConnection (TASE2ClientConnection* chosen)
+{
+    std::lock_guard<std::mutex> lock (m_activeConnectionMtx);
+
+    Tase2Utility::log_info ("Active connection %s:%d", chosen->IP ().c_str (),
+                            chosen->Port ());
+
+    m_active_connection = chosen;
+    m_active_connection->setPollingOnly (false);
+    m_active_connection->setPollingSuspended (false);
+    m_active_connection->Activate ();
+
+    for (auto clientConnection : *m_connections)
+    {
+        if (clientConnection == chosen)
+            continue;
+
+        if (m_config->pollOnStandby () && m_standby_connection == nullptr
+            && clientConnection->Connected ())
+        {
+            m_standby_connection = clientConnection;
+            m_activateStandby ();
+        }
+        else if (m_config->hotStandby ())
+        {
+            // armed once it is connected, it keeps reconnecting by itself
+            clientConnection->setPollingOnly (false);
+            clientConnection->Arm ();
+            clientConnection->Connect ();
         }
         else
         {
-            backupConnectionStartTime
-                = Hal_getTimeInMs () + BACKUP_CONNECTION_TIMEOUT;
+            clientConnection->Disconnect ();
+        }
+    }
+}
+
+/* open a second association to another server of the redundancy group
+ * and move the polling there, so that the active association only carries
+ * the DSTS reports and the commands. The active connection polls again as
+ * long as the standby is not connected. Called with m_activeConnectionMtx
+ * held. */
+void
+TASE2Client::m_superviseStandby ()
+{
+    if (m_standby_connection == nullptr)
+    {
+        for (auto clientConnection : *m_connections)
+        {
+            if (clientConnection != m_active_connection)
+            {
+                m_standby_connection = clientConnection;
+                break;
+            }
         }
 
-        Thread_sleep (100);
+        if (m_standby_connection == nullptr)
+            return;
+
+        m_activateStandby ();
     }
 
-    for (auto& clientConnection : *m_connections)
+    // a standby that reconnected has to be activated again
+    if (m_standby_connection->Connected ()
+        && !m_standby_connection->Active ())
     {
-        std::lock_guard<std::mutex> lock (m_activeConnectionMtx);
-        delete clientConnection;
+        m_standby_connection->Activate ();
     }
 
-    m_connections->clear ();
+    m_active_connection->setPollingSuspended (
+        m_standby_connection->Active ());
+}
+
+void
+TASE2Client::m_activateStandby ()
+{
+    Tase2Utility::log_info ("Polling over standby connection %s:%d",
+                            m_standby_connection->IP ().c_str (),
+                            m_standby_connection->Port ());
+
+    m_standby_connection->setPollingOnly (true);
+    m_standby_connection->Activate ();
+    m_standby_connection->Connect ();
+}
+
+/* stop the standby, the server it is connected to may be the next active
+ * one. Called with m_activeConnectionMtx held. */
+void
+TASE2Client::m_releaseStandby ()
+{
+    if (m_standby_connection == nullptr)
+        return;
+
+    m_standby_connection->Disconnect ();
+    m_standby_connection->setPollingOnly (false);
+    m_standby_connection = nullptr;
 }
 
 bool
@@ -292,7 +492,8 @@ TASE2Client::sendCommand (std::string domain, std::string name, int value,
     bool success = false;
 
     // check if the data point is in the exchange configuration
-    if (m_config->getExchangeDefinitionByRef (domain + ":" + name) == nullptr)
+    if (m_config->findExchangeDefinition (domain.c_str (), name.c_str ())
+        == nullptr)
     {
         Tase2Utility::log_error (
             "Failed to send command - no such data point");
@@ -309,8 +510,8 @@ TASE2Client::sendCommand (std::string domain, std::string name, int value,
     if (success)
     {
         Tase2_PointValue pointvalue = Tase2_PointValue_createDiscrete (value);
-        handleValue (domain + ":" + name, pointvalue, GetCurrentTimeInMs (),
-                     true);
+        handleValue (domain.c_str (), name.c_str (), pointvalue,
+                     GetCurrentTimeInMs (), true);
     }
 
     return success;
@@ -322,7 +523,8 @@ TASE2Client::sendSetPointReal (std::string domain, std::string name,
     bool success = false;
 
     // check if the data point is in the exchange configuration
-    if (m_config->getExchangeDefinitionByRef (domain + ":" + name) == nullptr)
+    if (m_config->findExchangeDefinition (domain.c_str (), name.c_str ())
+        == nullptr)
     {
         Tase2Utility::log_error (
             "Failed to send setpointreal - no such data point");
@@ -339,8 +541,8 @@ TASE2Client::sendSetPointReal (std::string domain, std::string name,
     if (success)
     {
         Tase2_PointValue pointvalue = Tase2_PointValue_createReal (value);
-        handleValue (domain + ":" + name, pointvalue, GetCurrentTimeInMs (),
-                     true);
+        handleValue (domain.c_str (), name.c_str (), pointvalue,
+                     GetCurrentTimeInMs (), true);
     }
 
     return success;
@@ -353,7 +555,8 @@ TASE2Client::sendSetPointDiscrete (std::string domain, std::string name,
     bool success = false;
 
     // check if the data point is in the exchange configuration
-    if (m_config->getExchangeDefinitionByRef (domain + ":" + name) == nullptr)
+    if (m_config->findExchangeDefinition (domain.c_str (), name.c_str ())
+        == nullptr)
     {
         Tase2Utility::log_error (
             "Failed to send setpointdiscrete - no such data point");
@@ -370,258 +573,604 @@ TASE2Client::sendSetPointDiscrete (std::string domain, std::string name,
     if (success)
     {
         Tase2_PointValue pointvalue = Tase2_PointValue_createDiscrete (value);
-        handleValue (domain + ":" + name, pointvalue, GetCurrentTimeInMs (),
-                     true);
+        handleValue (domain.c_str (), name.c_str (), pointvalue,
+                     GetCurrentTimeInMs (), true);
     }
 
     return success;
 }
 
 void
-TASE2Client::sendData (const std::vector<Datapoint*>& datapoints,
-                       const std::vector<std::string>& labels)
+TASE2Client::sendData (std::vector<Reading*>* readings)
 {
-    int i = 0;
+    if (readings->empty ())
+    {
+        delete readings;
+        return;
+    }
+
+    m_tase2->ingest (readings);
+}
 
-    for (Datapoint* item_dp : datapoints)
+/* the values of a DSTS report are ingested as a single batch. The markers
+ * use the slots reserved for them and never wait for the ingest thread.
+ * When even these are taken the report is not batched (false), endReport
+ * is then not called for it. */
+bool
+TASE2Client::beginReport ()
+{
+    PointUpdate marker;
+    marker.kind = PointUpdate::Kind::REPORT_BEGIN;
+
+    return m_queueMarker (marker);
+}
+
+void
+TASE2Client::endReport ()
+{
+    PointUpdate marker;
+    marker.kind = PointUpdate::Kind::REPORT_END;
+
+    // the ingest thread ends the report after REPORT_TIMEOUT
+    m_queueMarker (marker);
+}
+
+bool
+TASE2Client::m_queueMarker (const PointUpdate& marker)
+{
+    if (m_ingestQueue == nullptr)
     {
-        std::vector<Datapoint*> points;
-        points.push_back (item_dp);
+        return false;
+    }
 
-        m_tase2->ingest (labels.at (i), points);
-        i++;
+    if (!m_ingestQueue->tryPushReserved (marker))
+    {
+        m_splitReports++;
+        return false;
     }
+
+    m_wakeIngestThread ();
+
+    return true;
 }
 
 void
-TASE2Client::handleValue (std::string ref, Tase2_PointValue value,
-                          uint64_t timestamp, bool ack)
+TASE2Client::queueUpdate (const PointUpdate& update)
+{
+    m_queueUpdate (update, m_config->ingestOverflowPolicy ());
+}
+
+bool
+TASE2Client::refresh (const std::vector<std::string>& labels,
+                      const std::string& domain)
 {
-    std::vector<std::string> labels;
-    std::vector<Datapoint*> datapoints;
-    const std::shared_ptr<DataExchangeDefinition> def
-        = m_config->getExchangeDefinitionByRef (ref);
+    std::vector<PointId> points;
 
-    if (!def)
+    if (!labels.empty ())
     {
-        Tase2Utility::log_error ("Datapoint %s not in exchanged data ",
-                                 ref.c_str ());
-        return;
+        for (const auto& label : labels)
+        {
+            const DataExchangeDefinition* def
+                = m_config->getExchangeDefinitionByLabel (label);
+
+            if (def == nullptr || def->type >= COMMAND)
+            {
+                Tase2Utility::log_warn ("Refresh: no data point %s",
+                                        label.c_str ());
+                continue;
+            }
+
+            points.push_back (def->id);
+        }
+    }
+    else
+    {
+        for (const auto& def : m_config->ExchangeDefinition ())
+        {
+            if (def.type < COMMAND
+                && (domain.empty () || def.domain == domain))
+            {
+                points.push_back (def.id);
+            }
+        }
     }
 
-    DPTYPE typeId = def->type;
+    if (points.empty ())
+    {
+        Tase2Utility::log_error ("Refresh: no data points to read");
+        return false;
+    }
 
-    labels.push_back (def->label);
+    // the monitoring thread switches the connections during a failover
+    std::lock_guard<std::mutex> lock (m_activeConnectionMtx);
 
-    m_handleMonitoringData (def->ref, datapoints, def->label, typeId, value,
-                            timestamp);
+    // the polls, and so the cached values, are on the standby when it is up
+    TASE2ClientConnection* connection = m_active_connection;
 
-    sendData (datapoints, labels);
+    if (m_standby_connection != nullptr && m_standby_connection->Connected ())
+    {
+        connection = m_standby_connection;
+    }
 
-    if (ack)
+    if (connection == nullptr || !connection->refresh (points))
     {
-        Tase2_PointValue_destroy (value);
+        Tase2Utility::log_error ("Refresh: not connected");
+        return false;
     }
+
+    return true;
 }
 
 void
-TASE2Client::handleAllValues ()
+TASE2Client::handleValue (const char* domain, const char* name,
+                          Tase2_PointValue value, uint64_t timestamp, bool ack)
 {
-    std::vector<std::string> labels;
-    std::vector<Datapoint*> datapoints;
+    const DataExchangeDefinition* def
+        = m_config->findExchangeDefinition (domain, name);
 
-    for (const auto& pair : m_config->polledDatapoints ())
+    if (!def)
     {
-        const std::shared_ptr<DataExchangeDefinition> def = pair.second;
-
-        DPTYPE typeId = def->type;
-
-        labels.push_back (def->label);
+        Tase2Utility::log_error ("Datapoint %s:%s not in exchanged data ",
+                                 domain, name);
+    }
+    else
+    {
+        m_handleMonitoringData (def, value, timestamp);
+    }
 
-        m_handleMonitoringData (def->ref, datapoints, def->label, typeId,
-                                nullptr, GetCurrentTimeInMs ());
+    if (ack)
+    {
+        Tase2_PointValue_destroy (value);
     }
-    sendData (datapoints, labels);
 }
 
 void
-TASE2Client::m_handleMonitoringData (const std::string& ref,
-                                     std::vector<Datapoint*>& datapoints,
-                                     const std::string& label, DPTYPE type,
+TASE2Client::m_handleMonitoringData (const DataExchangeDefinition* def,
                                      Tase2_PointValue value,
                                      uint64_t timestamp)
 {
-    Tase2_ClientError error;
-
-    auto def = m_config->getExchangeDefinitionByRef (ref);
     if (!def)
     {
-        Tase2Utility::log_error ("Invalid definition for %s", ref.c_str ());
+        Tase2Utility::log_error ("Invalid definition");
         return;
     }
 
-    uint64_t ts = timestamp;
-
-    std::pair<std::string, std::string> domainNamePair
-        = TASE2ClientConfig::splitExchangeRef (ref);
-
-    Tase2_PointValue pointvalue;
-
     if (!value)
     {
-        pointvalue = m_active_connection->readValue (
-            &error, domainNamePair.first.c_str (),
-            domainNamePair.second.c_str ());
-    }
-    else
-    {
-        pointvalue = value;
+        Tase2Utility::log_error ("Couldn't get value for %s",
+                                 def->ref.c_str ());
+        return;
     }
 
-    if (!pointvalue)
+    m_queueValue (def, value, timestamp);
+}
+
+/* copy the parts of the point value we need, the value itself is owned by
+ * libtase2 and only valid during the callback */
+void
+TASE2Client::m_queueValue (const DataExchangeDefinition* def,
+                           Tase2_PointValue value, uint64_t timestamp)
+{
+    PointUpdate update;
+
+    update.def = def;
+    update.timestamp = timestamp;
+
+    def->converter->extract (value, update);
+
+    m_queueUpdate (update, m_config->ingestOverflowPolicy ());
+}
+
+void
+TASE2Client::m_queueUpdate (const PointUpdate& update, OverflowPolicy policy)
+{
+    if (m_ingestQueue == nullptr)
     {
-        Tase2Utility::log_error ("Couldn't get value for %s", ref.c_str ());
         return;
     }
 
-    datapoints.push_back (m_createDataObject (
-        pointvalue, domainNamePair.first, domainNamePair.second, ts, type));
+    m_ingestQueue->push (update, policy);
 
-    if (!value)
+    m_wakeIngestThread ();
+}
+
+void
+TASE2Client::m_wakeIngestThread ()
+{
+    // pairs with the fence in _ingestThread so that either the consumer sees
+    // the new item or we see that it is waiting
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+
+    if (m_ingestWaiting)
     {
-        Tase2_PointValue_destroy (pointvalue);
+        std::lock_guard<std::mutex> lock (m_ingestMtx);
+        m_ingestCond.notify_one ();
     }
 }
 
-static std::string
-validityToString (Tase2_DataFlags flags)
+/* readings made by the connection threads, the statistics. They are rare,
+ * a locked list is enough, but they must not wait for the south service. */
+void
+TASE2Client::m_queueReadings (std::vector<Reading*>* readings)
 {
-    if (flags | TASE2_DATA_FLAGS_VALIDITY_VALID)
+    if (m_ingestQueue == nullptr)
     {
-        return "valid";
+        for (Reading* reading : *readings)
+        {
+            delete reading;
+        }
+        delete readings;
+        return;
     }
-    else if (flags | TASE2_DATA_FLAGS_VALIDITY_HELD)
+
     {
-        return "held";
+        std::lock_guard<std::mutex> lock (m_queuedReadingsMtx);
+        m_queuedReadings.insert (m_queuedReadings.end (), readings->begin (),
+                                 readings->end ());
+        m_readingsQueued = true;
     }
-    else if (flags | TASE2_DATA_FLAGS_VALIDITY_SUSPECT)
+
+    delete readings;
+
+    m_wakeIngestThread ();
+}
+
+/* called by the ingest thread */
+void
+TASE2Client::m_sendQueuedReadings ()
+{
+    if (!m_readingsQueued)
     {
-        return "suspect";
+        return;
     }
-    else if (flags | TASE2_DATA_FLAGS_VALIDITY_NOTVALID)
+
+    auto readings = new std::vector<Reading*>;
+
     {
-        return "invalid";
+        std::lock_guard<std::mutex> lock (m_queuedReadingsMtx);
+        readings->swap (m_queuedReadings);
+        m_readingsQueued = false;
     }
-    return "";
+
+    sendData (readings);
 }
 
-static std::string
-currentSourceToString (Tase2_DataFlags flags)
+void
+TASE2Client::m_logIngestQueueMetrics ()
 {
-    if (flags | TASE2_DATA_FLAGS_CURRENT_SOURCE_TELEMETERED)
+    if (m_ingestQueue == nullptr)
     {
-        return "telemetered";
+        return;
     }
-    else if (flags | TASE2_DATA_FLAGS_CURRENT_SOURCE_ENTERED)
+
+    size_t hwm = m_ingestQueue->highWaterMark ();
+
+    if (hwm >= 2 * m_reportedHighWaterMark && hwm >= 1024)
     {
-        return "entered";
+        Tase2Utility::log_warn ("Ingest queue high-water mark: %zu of %zu",
+                                hwm, m_ingestQueue->capacity ());
+        m_reportedHighWaterMark = hwm;
     }
-    else if (flags | TASE2_DATA_FLAGS_CURRENT_SOURCE_CALCULATED)
+
+    uint64_t dropped = m_ingestQueue->dropped ();
+
+    if (dropped != m_reportedDropped)
     {
-        return "calculated";
+        Tase2Utility::log_error (
+            "Ingest queue overflow: %lu updates dropped (%lu in total)",
+            (unsigned long)(dropped - m_reportedDropped),
+            (unsigned long)dropped);
+        m_reportedDropped = dropped;
     }
-    else if (flags | TASE2_DATA_FLAGS_CURRENT_SOURCE_ESTIMATED)
+
+    uint64_t splitReports = m_splitReports;
+
+    if (splitReports != m_reportedSplitReports)
     {
-        return "estimated";
+        Tase2Utility::log_warn (
+            "Ingest queue full: %lu reports not ingested as one batch",
+            (unsigned long)(splitReports - m_reportedSplitReports));
+        m_reportedSplitReports = splitReports;
     }
-    return "";
 }
 
-static std::string
-normalValueToString (Tase2_DataFlags flags)
+/* maximum number of readings handed to the south service in one call */
+static const size_t MAX_INGEST_BATCH = 10000;
+
+/* a report that is not finished after this time is ingested anyway */
+static const std::chrono::milliseconds REPORT_TIMEOUT (1000);
+
+void
+TASE2Client::_ingestThread ()
 {
-    if (flags | TASE2_DATA_FLAGS_NORMAL_VALUE)
+    std::vector<Reading*>* readings = nullptr;
+    int openReports = 0;
+    PointUpdate update;
+    UpdateWindows::Output windowOutput;
+    uint64_t reportStart = 0; // of the first report still open
+
+    auto flush = [this, &readings] () {
+        if (readings)
+        {
+            sendData (readings);
+            readings = nullptr;
+        }
+    };
+
+    auto ingest = [this, &readings, &flush, &windowOutput] () {
+        for (const WindowedUpdate& value : windowOutput)
+        {
+            if (readings == nullptr)
+            {
+                readings = new std::vector<Reading*>;
+            }
+
+            Datapoint* dataObject = m_createDataObject (value.update);
+
+            if (value.aggregate)
+            {
+                m_addAggregate (dataObject, value.stats);
+            }
+
+            readings->push_back (
+                new Reading (value.update.def->label, dataObject));
+
+            if (readings->size () >= MAX_INGEST_BATCH)
+            {
+                flush ();
+            }
+        }
+
+        windowOutput.clear ();
+    };
+
+    while (true)
     {
-        return "normal";
+        bool running = m_ingestRunning;
+        uint64_t now = getMonotonicTimeInMs ();
+
+        while (m_ingestQueue->tryPop (update))
+        {
+            switch (update.kind)
+            {
+            case PointUpdate::Kind::VALUE:
+                if (m_isFiltered (update))
+                {
+                    break;
+                }
+
+                m_windows.add (update, now, windowOutput);
+                ingest ();
+                break;
+
+            case PointUpdate::Kind::REPORT_BEGIN:
+                if (openReports++ == 0)
+                {
+                    reportStart = now;
+                }
+                break;
+
+            case PointUpdate::Kind::REPORT_END:
+                if (openReports > 0)
+                {
+                    openReports--;
+                }
+                if (openReports == 0)
+                {
+                    flush ();
+                }
+                break;
+            }
+        }
+
+        m_windows.expire (now, windowOutput);
+        ingest ();
+
+        // counted from the begin marker, the values that keep coming in
+        // don't hold back a report whose end marker was lost
+        if (openReports > 0
+            && now - reportStart >= (uint64_t)REPORT_TIMEOUT.count ())
+        {
+            Tase2Utility::log_warn (
+                "Report not finished within %ld ms -> ingest anyway",
+                (long)REPORT_TIMEOUT.count ());
+            openReports = 0;
+        }
+
+        // values received outside of a report are sent right away
+        if (openReports == 0)
+        {
+            flush ();
+        }
+
+        m_sendQueuedReadings ();
+
+        m_logIngestQueueMetrics ();
+
+        if (!running)
+        {
+            break;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock (m_ingestMtx);
+
+            m_ingestWaiting = true;
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+
+            if (m_ingestQueue->empty () && !m_readingsQueued
+                && m_ingestRunning)
+            {
+                std::chrono::milliseconds timeout = REPORT_TIMEOUT;
+                uint64_t deadline = m_windows.nextDeadline ();
+
+                if (openReports > 0)
+                {
+                    uint64_t reportEnd
+                        = reportStart + (uint64_t)REPORT_TIMEOUT.count ();
+
+                    if (deadline == 0 || reportEnd < deadline)
+                        deadline = reportEnd;
+                }
+
+                if (deadline != 0)
+                {
+                    now = getMonotonicTimeInMs ();
+                    timeout = std::min (
+                        timeout, std::chrono::milliseconds (
+                                     deadline > now ? deadline - now : 0));
+                }
+
+                m_ingestCond.wait_for (lock, timeout);
+            }
+
+            m_ingestWaiting = false;
+        }
     }
-    return "abnormal";
+
+    m_windows.flush (windowOutput);
+    ingest ();
+    flush ();
+    m_sendQueuedReadings ();
 }
 
-Datapoint*
-TASE2Client::m_createDataObject (Tase2_PointValue value,
-                                 const std::string& domain,
-                                 const std::string& name, uint64_t ts,
-                                 DPTYPE type)
+/* update the last value cache, true when the update can be dropped.
+ * Quality changes and heartbeats are always ingested. */
+bool
+TASE2Client::m_isFiltered (const PointUpdate& update)
 {
-    auto datapoints = new std::vector<Datapoint*>;
-
-    datapoints->push_back (createDatapoint ("do_type", dpTypeToStr (type)));
-    datapoints->push_back (createDatapoint ("do_domain", domain));
-    datapoints->push_back (createDatapoint ("do_name", name));
+    const DataExchangeDefinition* def = update.def;
 
-    switch (type)
+    if (def->id >= m_lastValues.size ())
     {
-    case COMMAND:
-    case SETPOINTDISCRETE:
-    case DISCRETE:
-    case DISCRETEQ:
-    case DISCRETEQTIME:
-    case DISCRETEQTIMEEXT: {
-        datapoints->push_back (createDatapoint (
-            "do_value", (int64_t)Tase2_PointValue_getValueDiscrete (value)));
-        break;
-    }
-    case STATESUP:
-    case STATESUPQ:
-    case STATESUPQTIME:
-    case STATESUPQTIMEEXT: {
-        datapoints->push_back (createDatapoint (
-            "do_value",
-            (int64_t)Tase2_PointValue_getValueStateSupplemental (value)));
-        break;
-    }
-    case STATE:
-    case STATEQ:
-    case STATEQTIME:
-    case STATEQTIMEEXT: {
-        datapoints->push_back (createDatapoint (
-            "do_value", (int64_t)Tase2_PointValue_getValueState (value)));
-        break;
-    }
-    case SETPOINTREAL:
-    case REAL:
-    case REALQ:
-    case REALQTIME:
-    case REALQTIMEEXT: {
-        datapoints->push_back (createDatapoint (
-            "do_value", (double)Tase2_PointValue_getValueReal (value)));
-        break;
-    }
-    default: {
-        break;
+        return false;
     }
+
+    // aggregation needs every value
+    if (def->aggregateWindow > 0)
+    {
+        return false;
     }
 
-    if (hasQuality (type))
+    LastValue& last = m_lastValues[def->id];
+
+    bool filtered = false;
+
+    if (last.valid && last.flags == update.flags
+        && (def->heartbeat == 0
+            || update.timestamp < last.emitted + def->heartbeat))
     {
-        Tase2_DataFlags flags = Tase2_PointValue_getFlags (value);
-        datapoints->push_back (
-            createDatapoint ("do_validity", validityToString (flags)));
-        datapoints->push_back (
-            createDatapoint ("do_cs", currentSourceToString (flags)));
-        datapoints->push_back (createDatapoint ("do_quality_normal_value",
-                                                normalValueToString (flags)));
+        if (def->suppressUnchanged && last.sameAs (update))
+        {
+            m_suppressedUpdates++;
+            filtered = true;
+        }
+        else if (def->deadband > 0.0)
+        {
+            double deadband = def->deadband;
+
+            if (def->deadbandPercent)
+            {
+                deadband *= std::fabs (last.emittedValue) / 100.0;
+            }
+
+            if (std::fabs (update.realValue - last.emittedValue) <= deadband)
+            {
+                m_deadbandFilteredUpdates++;
+                filtered = true;
+            }
+        }
     }
 
-    if (hasTimestamp (type))
+    last.valid = true;
+    last.realValue = update.realValue;
+    last.intValue = update.intValue;
+    last.flags = update.flags;
+    last.timestamp = update.sourceTimestamp != 0 ? update.sourceTimestamp
+                                                 : update.timestamp;
+
+    if (!filtered)
     {
-        datapoints->push_back (createDatapoint ("do_ts", (long)ts));
-        datapoints->push_back (createDatapoint ("do_ts_validity", "valid"));
+        last.emitted = update.timestamp;
+        last.emittedValue = update.realValue;
     }
 
-    DatapointValue dpv (datapoints, true);
+    return filtered;
+}
 
-    Datapoint* dp = new Datapoint ("data_object", dpv);
+/* statistics of an aggregation window, do_value is the last value */
+void
+TASE2Client::m_addAggregate (Datapoint* dataObject,
+                             const AggregateStats& stats)
+{
+    addElementWithValue (dataObject, "do_min", stats.min);
+    addElementWithValue (dataObject, "do_max", stats.max);
+    addElementWithValue (dataObject, "do_mean", stats.sum / stats.count);
+    addElementWithValue (dataObject, "do_count", (int64_t)stats.count);
+}
 
-    return dp;
+/* connect attempts and reconnects of a connection, sent when it connects */
+void
+TASE2Client::sendConnectionStatistics (const std::string& connection,
+                                       uint64_t connectAttempts,
+                                       uint64_t reconnects,
+                                       uint64_t timeToReconnect)
+{
+    if (m_config->statisticsAsset ().empty ())
+        return;
+
+    Datapoint* stats = createDp ("connection_statistics");
+
+    addElementWithValue (stats, "connection", connection);
+    addElementWithValue (stats, "connect_attempts", (int64_t)connectAttempts);
+    addElementWithValue (stats, "reconnects", (int64_t)reconnects);
+    addElementWithValue (stats, "time_to_reconnect", (int64_t)timeToReconnect);
+
+    auto readings = new std::vector<Reading*>;
+    readings->push_back (new Reading (m_config->statisticsAsset (), stats));
+
+    m_queueReadings (readings);
+}
+
+/* one reading per polling interval of the connection */
+void
+TASE2Client::sendPollStatistics (
+    const std::string& connection,
+    const std::vector<TASE2ClientConnection::PollCycleStats>& cycles)
+{
+    auto readings = new std::vector<Reading*>;
+
+    for (const auto& cycle : cycles)
+    {
+        Datapoint* stats = createDp ("poll_statistics");
+
+        addElementWithValue (stats, "connection", connection);
+        addElementWithValue (stats, "interval", (int64_t)cycle.interval);
+        addElementWithValue (stats, "effective_interval",
+                             (int64_t)cycle.effectiveInterval);
+        addElementWithValue (stats, "cycles", (int64_t)cycle.cycles);
+        addElementWithValue (stats, "overruns", (int64_t)cycle.overruns);
+        addElementWithValue (stats, "points", (int64_t)cycle.points);
+        addElementWithValue (stats, "slack", (int64_t)cycle.slack);
+        addElementWithValue (stats, "duration_p50",
+                             (int64_t)cycle.durationPercentile (50));
+        addElementWithValue (stats, "duration_p95",
+                             (int64_t)cycle.durationPercentile (95));
+        addElementWithValue (stats, "duration_p99",
+                             (int64_t)cycle.durationPercentile (99));
+        addElementWithValue (stats, "duration_max",
+                             (int64_t)cycle.maxDuration);
+        addElementWithValue (stats, "max_lateness",
+                             (int64_t)cycle.maxLateness);
+
+        readings->push_back (new Reading (m_config->statisticsAsset (), stats));
+    }
+
+    m_queueReadings (readings);
+}
+
+Datapoint*
+TASE2Client::m_createDataObject (const PointUpdate& update)
+{
+    return update.def->converter->createDataObject (update);
 }
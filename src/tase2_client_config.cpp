@@ -1,4 +1,5 @@
 #include "tase2_client_config.hpp"
+#include "tase2_value_converter.hpp"
 #include <algorithm>
 #include <arpa/inet.h>
 #include <regex>
@@ -16,6 +17,8 @@
 #define JSON_DATASET_REF "dataset_ref"
 #define JSON_DATASET_ENTRIES "entries"
 #define JSON_POLLING_INTERVAL "polling_interval"
+#define JSON_POLL_GROUPS "poll_groups"
+#define JSON_POLL_GROUP "poll_group"
 #define JSON_DATASET_TRANSFER_SETS "dataset_transfer_sets"
 #define JSON_NAME "name"
 #define JSON_DSTS_CON "dsConditions"
@@ -32,6 +35,32 @@
 #define JSON_RBE "rbe"
 #define JSON_ALL_CHANGES_REPORTED "allChangesReported"
 #define JSON_OSI "osi"
+#define JSON_INGEST_QUEUE_SIZE "ingest_queue_size"
+#define JSON_INGEST_OVERFLOW_POLICY "ingest_overflow_policy"
+#define JSON_BULK_POLLING "bulk_polling"
+#define JSON_MAX_PDU_SIZE "max_pdu_size"
+#define JSON_MAX_DATASET_MEMBERS "max_dataset_members"
+#define JSON_POLL_SCHEDULE "poll_schedule"
+#define JSON_MAX_POLL_READS "max_poll_reads"
+#define JSON_OVERRUN_POLICY "overrun_policy"
+#define JSON_STATISTICS_ASSET "statistics_asset"
+#define JSON_STATISTICS_PERIOD "statistics_period"
+#define JSON_ADAPTIVE_POLLING "adaptive_polling"
+#define JSON_UNCHANGED_POLLS "unchanged_polls"
+#define JSON_BACKOFF_FACTOR "backoff_factor"
+#define JSON_MAX_INTERVAL "max_interval"
+#define JSON_MAX_OUTSTANDING_READS "max_outstanding_reads"
+#define JSON_REFRESH_TTL "refresh_ttl"
+#define JSON_FALLBACK_POLLING_INTERVAL "fallback_polling_interval"
+#define JSON_DSTS_RETRY_INTERVAL "dsts_retry_interval"
+#define JSON_POLL_ON_STANDBY "poll_on_standby"
+#define JSON_SUPPRESS_UNCHANGED "suppress_unchanged"
+#define JSON_HEARTBEAT "heartbeat"
+#define JSON_DEADBAND "deadband"
+#define JSON_DEADBAND_TYPE "deadband_type"
+#define JSON_COALESCE_WINDOW "coalesce_window"
+#define JSON_COALESCE_MODE "coalesce_mode"
+#define JSON_AGGREGATE "aggregate"
 
 #define JSON_LOCAL_AP "local_ap_title"
 #define JSON_LOCAL_AE "local_ae_qualifier"
@@ -76,6 +105,7 @@ static const std::unordered_map<std::string, Type> expectedTypeMap
         { JSON_DATASET_REF, kStringType },
         { JSON_DATASET_ENTRIES, kArrayType },
         { JSON_POLLING_INTERVAL, kNumberType },
+        { JSON_POLL_GROUPS, kArrayType },
         { JSON_DATASET_TRANSFER_SETS, kArrayType },
         { JSON_NAME, kStringType },
         { JSON_DSTS_CON, kArrayType },
@@ -87,6 +117,23 @@ static const std::unordered_map<std::string, Type> expectedTypeMap
         { JSON_RBE, kTrueType },
         { JSON_ALL_CHANGES_REPORTED, kTrueType },
         { JSON_OSI, kObjectType },
+        { JSON_INGEST_QUEUE_SIZE, kNumberType },
+        { JSON_INGEST_OVERFLOW_POLICY, kStringType },
+        { JSON_BULK_POLLING, kTrueType },
+        { JSON_MAX_PDU_SIZE, kNumberType },
+        { JSON_MAX_DATASET_MEMBERS, kNumberType },
+        { JSON_POLL_SCHEDULE, kStringType },
+        { JSON_MAX_POLL_READS, kNumberType },
+        { JSON_OVERRUN_POLICY, kStringType },
+        { JSON_STATISTICS_ASSET, kStringType },
+        { JSON_STATISTICS_PERIOD, kNumberType },
+        { JSON_MAX_OUTSTANDING_READS, kNumberType },
+        { JSON_REFRESH_TTL, kNumberType },
+        { JSON_FALLBACK_POLLING_INTERVAL, kNumberType },
+        { JSON_DSTS_RETRY_INTERVAL, kNumberType },
+        { JSON_POLL_ON_STANDBY, kTrueType },
+        { JSON_SUPPRESS_UNCHANGED, kTrueType },
+        { JSON_HEARTBEAT, kNumberType },
         { JSON_LOCAL_AP, kStringType },
         { JSON_LOCAL_AE, kNumberType },
         { JSON_REMOTE_AP, kStringType },
@@ -119,6 +166,22 @@ const static std::unordered_map<std::string, DPTYPE> dpTypeMap
         { "SetPointReal", SETPOINTREAL },
         { "SetPointDiscrete", SETPOINTDISCRETE } };
 
+static const std::unordered_map<std::string, OverflowPolicy>
+    overflowPolicyMap = { { "drop_newest", OverflowPolicy::DROP_NEWEST },
+                          { "drop_oldest", OverflowPolicy::DROP_OLDEST },
+                          { "block", OverflowPolicy::BLOCK } };
+
+static const std::unordered_map<std::string, PollSchedule> pollScheduleMap
+    = { { "burst", PollSchedule::BURST }, { "spread", PollSchedule::SPREAD } };
+
+/* upper limit of max_outstanding_reads, one thread per outstanding read */
+static const int MAX_OUTSTANDING_READS = 32;
+
+static const std::unordered_map<std::string, OverrunPolicy> overrunPolicyMap
+    = { { "skip", OverrunPolicy::SKIP },
+        { "catch_up", OverrunPolicy::CATCH_UP },
+        { "stretch", OverrunPolicy::STRETCH } };
+
 DPTYPE
 TASE2ClientConfig::getDpTypeFromString (const std::string& type)
 {
@@ -163,7 +226,9 @@ TASE2ClientConfig::isValidIPAddress (const std::string& addrStr)
 void
 TASE2ClientConfig::deleteExchangeDefinitions ()
 {
+    m_exchangeDefinitionsIndex.clear ();
     m_exchangeDefinitions.clear ();
+    m_exchangeDefinitionsLabel.clear ();
     m_exchangeDefinitionsRef.clear ();
     m_polledDatapoints.clear ();
 }
@@ -328,6 +393,49 @@ TASE2ClientConfig::importProtocolConfig (const std::string& protocolConfig)
         m_backupConnectionTimeout = transportLayer["backupTimeout"].GetInt ();
     }
 
+    if (transportLayer.HasMember ("connectGraceWindow"))
+    {
+        m_connectGraceWindow
+            = transportLayer["connectGraceWindow"].GetInt ();
+    }
+
+    if (transportLayer.HasMember ("connectTimeout")
+        && transportLayer["connectTimeout"].IsUint ())
+    {
+        m_connectTimeout = transportLayer["connectTimeout"].GetUint ();
+    }
+
+    if (transportLayer.HasMember ("reconnectDelay")
+        && transportLayer["reconnectDelay"].IsUint ())
+    {
+        m_reconnectDelay = transportLayer["reconnectDelay"].GetUint ();
+    }
+
+    if (transportLayer.HasMember ("maxReconnectDelay")
+        && transportLayer["maxReconnectDelay"].IsUint ())
+    {
+        m_maxReconnectDelay = transportLayer["maxReconnectDelay"].GetUint ();
+    }
+
+    if (transportLayer.HasMember ("reconnectJitter")
+        && transportLayer["reconnectJitter"].IsNumber ())
+    {
+        m_reconnectJitter = transportLayer["reconnectJitter"].GetDouble ();
+
+        if (m_reconnectJitter < 0.0 || m_reconnectJitter > 1.0)
+        {
+            Tase2Utility::log_warn ("reconnectJitter out of range (0..1) "
+                                    "-> using 0.2");
+            m_reconnectJitter = 0.2;
+        }
+    }
+
+    if (transportLayer.HasMember ("hotStandby")
+        && transportLayer["hotStandby"].IsBool ())
+    {
+        m_hotStandby = transportLayer["hotStandby"].GetBool ();
+    }
+
     if (!protocolStack.HasMember (JSON_APPLICATION_LAYER))
     {
         Tase2Utility::log_fatal ("transport layer configuration is missing");
@@ -347,6 +455,234 @@ TASE2ClientConfig::importProtocolConfig (const std::string& protocolConfig)
         pollingInterval = intVal;
     }
 
+    if (applicationLayer.HasMember (JSON_INGEST_QUEUE_SIZE))
+    {
+        int intVal = applicationLayer[JSON_INGEST_QUEUE_SIZE].GetInt ();
+        if (intVal <= 0)
+        {
+            Tase2Utility::log_error ("%s must be positive -> using %u",
+                                     JSON_INGEST_QUEUE_SIZE,
+                                     (unsigned)m_ingestQueueSize);
+        }
+        else
+        {
+            m_ingestQueueSize = intVal;
+        }
+    }
+
+    if (applicationLayer.HasMember (JSON_INGEST_OVERFLOW_POLICY))
+    {
+        std::string policy
+            = applicationLayer[JSON_INGEST_OVERFLOW_POLICY].GetString ();
+        auto it = overflowPolicyMap.find (policy);
+        if (it != overflowPolicyMap.end ())
+        {
+            m_ingestOverflowPolicy = it->second;
+        }
+        else
+        {
+            Tase2Utility::log_error (
+                "Invalid %s: %s -> using drop_newest",
+                JSON_INGEST_OVERFLOW_POLICY, policy.c_str ());
+        }
+    }
+
+    if (applicationLayer.HasMember (JSON_POLL_GROUPS))
+    {
+        std::unordered_map<std::string, uint64_t> pollGroups;
+
+        for (const auto& groupVal :
+             applicationLayer[JSON_POLL_GROUPS].GetArray ())
+        {
+            if (!groupVal.IsObject () || !groupVal.HasMember (JSON_NAME)
+                || !groupVal.HasMember (JSON_POLLING_INTERVAL)
+                || groupVal[JSON_POLLING_INTERVAL].GetInt () <= 0)
+            {
+                Tase2Utility::log_error ("Invalid poll group -> ignore");
+                continue;
+            }
+
+            pollGroups[groupVal[JSON_NAME].GetString ()]
+                = groupVal[JSON_POLLING_INTERVAL].GetInt ();
+        }
+
+        m_applyPollGroups (pollGroups);
+    }
+
+    if (applicationLayer.HasMember (JSON_BULK_POLLING))
+    {
+        m_bulkPolling = applicationLayer[JSON_BULK_POLLING].GetBool ();
+    }
+
+    if (applicationLayer.HasMember (JSON_POLL_ON_STANDBY))
+    {
+        m_pollOnStandby = applicationLayer[JSON_POLL_ON_STANDBY].GetBool ();
+    }
+
+    if (applicationLayer.HasMember (JSON_MAX_PDU_SIZE))
+    {
+        int intVal = applicationLayer[JSON_MAX_PDU_SIZE].GetInt ();
+        if (intVal < 1024)
+        {
+            Tase2Utility::log_error ("%s must be at least 1024 -> using %u",
+                                     JSON_MAX_PDU_SIZE,
+                                     (unsigned)m_maxPduSize);
+        }
+        else
+        {
+            m_maxPduSize = intVal;
+        }
+    }
+
+    if (applicationLayer.HasMember (JSON_MAX_DATASET_MEMBERS))
+    {
+        int intVal = applicationLayer[JSON_MAX_DATASET_MEMBERS].GetInt ();
+        if (intVal < 1)
+        {
+            Tase2Utility::log_error ("%s must be at least 1 -> using %u",
+                                     JSON_MAX_DATASET_MEMBERS,
+                                     (unsigned)m_maxDataSetMembers);
+        }
+        else
+        {
+            m_maxDataSetMembers = intVal;
+        }
+    }
+
+    if (applicationLayer.HasMember (JSON_POLL_SCHEDULE))
+    {
+        std::string schedule
+            = applicationLayer[JSON_POLL_SCHEDULE].GetString ();
+        auto it = pollScheduleMap.find (schedule);
+        if (it != pollScheduleMap.end ())
+        {
+            m_pollSchedule = it->second;
+        }
+        else
+        {
+            Tase2Utility::log_error ("Invalid %s: %s -> using burst",
+                                     JSON_POLL_SCHEDULE, schedule.c_str ());
+        }
+    }
+
+    if (applicationLayer.HasMember (JSON_MAX_POLL_READS))
+    {
+        int intVal = applicationLayer[JSON_MAX_POLL_READS].GetInt ();
+        if (intVal < 0)
+        {
+            Tase2Utility::log_error ("%s must not be negative -> no limit",
+                                     JSON_MAX_POLL_READS);
+        }
+        else
+        {
+            m_maxPollReads = intVal;
+        }
+    }
+
+    if (applicationLayer.HasMember (JSON_OVERRUN_POLICY))
+    {
+        std::string policy
+            = applicationLayer[JSON_OVERRUN_POLICY].GetString ();
+        auto it = overrunPolicyMap.find (policy);
+        if (it != overrunPolicyMap.end ())
+        {
+            m_overrunPolicy = it->second;
+        }
+        else
+        {
+            Tase2Utility::log_error ("Invalid %s: %s -> using skip",
+                                     JSON_OVERRUN_POLICY, policy.c_str ());
+        }
+    }
+
+    if (applicationLayer.HasMember (JSON_MAX_OUTSTANDING_READS))
+    {
+        int intVal = applicationLayer[JSON_MAX_OUTSTANDING_READS].GetInt ();
+        if (intVal < 1 || intVal > MAX_OUTSTANDING_READS)
+        {
+            Tase2Utility::log_error ("%s must be between 1 and %d -> using %d",
+                                     JSON_MAX_OUTSTANDING_READS,
+                                     MAX_OUTSTANDING_READS,
+                                     m_maxOutstandingReads);
+        }
+        else
+        {
+            m_maxOutstandingReads = intVal;
+        }
+    }
+
+    if (applicationLayer.HasMember (JSON_REFRESH_TTL))
+    {
+        int intVal = applicationLayer[JSON_REFRESH_TTL].GetInt ();
+        if (intVal < 0)
+        {
+            Tase2Utility::log_error ("%s must not be negative -> using %lu",
+                                     JSON_REFRESH_TTL,
+                                     (unsigned long)m_refreshTtl);
+        }
+        else
+        {
+            m_refreshTtl = intVal;
+        }
+    }
+
+    if (applicationLayer.HasMember (JSON_FALLBACK_POLLING_INTERVAL))
+    {
+        int intVal
+            = applicationLayer[JSON_FALLBACK_POLLING_INTERVAL].GetInt ();
+        if (intVal < 0)
+        {
+            Tase2Utility::log_error ("%s must not be negative -> using %lu",
+                                     JSON_FALLBACK_POLLING_INTERVAL,
+                                     (unsigned long)m_fallbackPollingInterval);
+        }
+        else
+        {
+            m_fallbackPollingInterval = intVal;
+        }
+    }
+
+    if (applicationLayer.HasMember (JSON_DSTS_RETRY_INTERVAL))
+    {
+        int intVal = applicationLayer[JSON_DSTS_RETRY_INTERVAL].GetInt ();
+        if (intVal < 1000)
+        {
+            Tase2Utility::log_error ("%s must be at least 1000 -> using %lu",
+                                     JSON_DSTS_RETRY_INTERVAL,
+                                     (unsigned long)m_dstsRetryInterval);
+        }
+        else
+        {
+            m_dstsRetryInterval = intVal;
+        }
+    }
+
+    if (applicationLayer.HasMember (JSON_ADAPTIVE_POLLING))
+    {
+        importAdaptivePolling (applicationLayer[JSON_ADAPTIVE_POLLING]);
+    }
+
+    if (applicationLayer.HasMember (JSON_STATISTICS_ASSET))
+    {
+        m_statisticsAsset
+            = applicationLayer[JSON_STATISTICS_ASSET].GetString ();
+    }
+
+    if (applicationLayer.HasMember (JSON_STATISTICS_PERIOD))
+    {
+        int intVal = applicationLayer[JSON_STATISTICS_PERIOD].GetInt ();
+        if (intVal < 1000)
+        {
+            Tase2Utility::log_error ("%s must be at least 1000 -> using %lu",
+                                     JSON_STATISTICS_PERIOD,
+                                     (unsigned long)m_statisticsPeriod);
+        }
+        else
+        {
+            m_statisticsPeriod = intVal;
+        }
+    }
+
     if (applicationLayer.HasMember (JSON_DATASETS))
     {
         for (const auto& datasetVal :
@@ -378,15 +714,14 @@ TASE2ClientConfig::importProtocolConfig (const std::string& protocolConfig)
                     {
                         std::string name = entryVal.GetString ();
 
-                        const std::shared_ptr<DataExchangeDefinition> def
-                            = getExchangeDefinitionByRef (domainName + ":"
-                                                          + name);
+                        auto it = m_exchangeDefinitionsRef.find (
+                            domainName + ":" + name);
 
                         dataset->entries.push_back (name);
 
-                        if (def)
+                        if (it != m_exchangeDefinitionsRef.end ())
                         {
-                            m_polledDatapoints.erase (domainName + ":" + name);
+                            m_exchangeDefinitions[it->second].polled = false;
                         }
                     }
                 }
@@ -407,6 +742,8 @@ TASE2ClientConfig::importProtocolConfig (const std::string& protocolConfig)
         }
     }
 
+    m_updatePolledDatapoints ();
+
     if (applicationLayer.HasMember (JSON_DATASET_TRANSFER_SETS))
     {
         for (const auto& dstsVal :
@@ -505,10 +842,25 @@ TASE2ClientConfig::importProtocolConfig (const std::string& protocolConfig)
                     = dstsVal[JSON_ALL_CHANGES_REPORTED].GetBool ();
             }
 
+            if (dstsVal.HasMember (JSON_SUPPRESS_UNCHANGED))
+            {
+                dsts->suppressUnchanged
+                    = dstsVal[JSON_SUPPRESS_UNCHANGED].GetBool ();
+            }
+
+            if (dstsVal.HasMember (JSON_HEARTBEAT)
+                && dstsVal[JSON_HEARTBEAT].GetInt () > 0)
+            {
+                dsts->heartbeat = dstsVal[JSON_HEARTBEAT].GetInt ();
+            }
+
             m_dsTranferSets.insert ({ dsts->dstsRef, std::move (dsts) });
         }
     }
 
+    m_resolveDatasetPoints ();
+    m_applyDstsPointOptions ();
+
     m_protocolConfigComplete = true;
 }
 
@@ -763,6 +1115,293 @@ TASE2ClientConfig::parseOsiSelector (std::string& inputOsiSelector,
 
 void
 TASE2ClientConfig::importExchangeConfig (const std::string& exchangeConfig)
+{
+    deleteExchangeDefinitions ();
+
+    m_parseExchangeConfig (exchangeConfig);
+
+    // the definitions don't move anymore, index them
+    m_exchangeDefinitions.shrink_to_fit ();
+
+    for (const auto& def : m_exchangeDefinitions)
+    {
+        m_exchangeDefinitionsIndex.insert (&def);
+    }
+
+    m_updatePolledDatapoints ();
+}
+
+void
+TASE2ClientConfig::m_updatePolledDatapoints ()
+{
+    m_polledDatapoints.clear ();
+
+    for (const auto& def : m_exchangeDefinitions)
+    {
+        if (def.polled)
+        {
+            m_polledDatapoints.push_back (def.id);
+        }
+    }
+}
+
+void
+TASE2ClientConfig::importDeadband (const rapidjson::Value& protocol,
+                                   DataExchangeDefinition& def)
+{
+    if (!protocol[JSON_DEADBAND].IsNumber ()
+        || protocol[JSON_DEADBAND].GetDouble () < 0)
+    {
+        Tase2Utility::log_error ("Invalid deadband for %s -> ignore",
+                                 def.label.c_str ());
+        return;
+    }
+
+    if (def.type > REALQTIMEEXT)
+    {
+        Tase2Utility::log_warn ("Deadband for %s ignored, not a Real type",
+                                def.label.c_str ());
+        return;
+    }
+
+    def.deadband = protocol[JSON_DEADBAND].GetDouble ();
+
+    if (protocol.HasMember (JSON_DEADBAND_TYPE)
+        && protocol[JSON_DEADBAND_TYPE].IsString ())
+    {
+        std::string deadbandType = protocol[JSON_DEADBAND_TYPE].GetString ();
+
+        if (deadbandType == "percent")
+        {
+            def.deadbandPercent = true;
+        }
+        else if (deadbandType != "absolute")
+        {
+            Tase2Utility::log_warn (
+                "Unknown deadband_type %s for %s -> use absolute",
+                deadbandType.c_str (), def.label.c_str ());
+        }
+    }
+}
+
+void
+TASE2ClientConfig::importCoalesce (const rapidjson::Value& protocol,
+                                   DataExchangeDefinition& def)
+{
+    if (!protocol[JSON_COALESCE_WINDOW].IsInt ()
+        || protocol[JSON_COALESCE_WINDOW].GetInt () < 0)
+    {
+        Tase2Utility::log_error ("Invalid coalesce_window for %s -> ignore",
+                                 def.label.c_str ());
+        return;
+    }
+
+    def.coalesceWindow = protocol[JSON_COALESCE_WINDOW].GetInt ();
+
+    if (protocol.HasMember (JSON_COALESCE_MODE)
+        && protocol[JSON_COALESCE_MODE].IsString ())
+    {
+        std::string mode = protocol[JSON_COALESCE_MODE].GetString ();
+
+        if (mode == "first_last")
+        {
+            def.coalesceMode = CoalesceMode::FIRST_LAST;
+        }
+        else if (mode != "latest")
+        {
+            Tase2Utility::log_warn (
+                "Unknown coalesce_mode %s for %s -> use latest", mode.c_str (),
+                def.label.c_str ());
+        }
+    }
+}
+
+void
+TASE2ClientConfig::importAggregate (const rapidjson::Value& protocol,
+                                    DataExchangeDefinition& def)
+{
+    if (!protocol[JSON_AGGREGATE].IsInt ()
+        || protocol[JSON_AGGREGATE].GetInt () < 0)
+    {
+        Tase2Utility::log_error ("Invalid aggregate window for %s -> ignore",
+                                 def.label.c_str ());
+        return;
+    }
+
+    if (def.type > REALQTIMEEXT)
+    {
+        Tase2Utility::log_warn ("Aggregate for %s ignored, not a Real type",
+                                def.label.c_str ());
+        return;
+    }
+
+    def.aggregateWindow = protocol[JSON_AGGREGATE].GetInt ();
+
+    if (def.aggregateWindow > 0 && def.coalesceWindow > 0)
+    {
+        Tase2Utility::log_warn ("%s is aggregated, coalesce_window ignored",
+                                def.label.c_str ());
+    }
+}
+
+void
+TASE2ClientConfig::importAdaptivePolling (const Value& adaptive)
+{
+    if (!adaptive.IsObject ())
+    {
+        Tase2Utility::log_error ("%s must be an object -> disabled",
+                                 JSON_ADAPTIVE_POLLING);
+        return;
+    }
+
+    m_adaptivePolling.enabled = true;
+
+    if (adaptive.HasMember (JSON_UNCHANGED_POLLS))
+    {
+        if (adaptive[JSON_UNCHANGED_POLLS].IsInt ()
+            && adaptive[JSON_UNCHANGED_POLLS].GetInt () > 0)
+        {
+            m_adaptivePolling.unchangedPolls
+                = adaptive[JSON_UNCHANGED_POLLS].GetInt ();
+        }
+        else
+        {
+            Tase2Utility::log_error ("Invalid %s -> using %d",
+                                     JSON_UNCHANGED_POLLS,
+                                     m_adaptivePolling.unchangedPolls);
+        }
+    }
+
+    if (adaptive.HasMember (JSON_BACKOFF_FACTOR))
+    {
+        if (adaptive[JSON_BACKOFF_FACTOR].IsNumber ()
+            && adaptive[JSON_BACKOFF_FACTOR].GetDouble () > 1.0)
+        {
+            m_adaptivePolling.factor
+                = adaptive[JSON_BACKOFF_FACTOR].GetDouble ();
+        }
+        else
+        {
+            Tase2Utility::log_error ("Invalid %s -> using %g",
+                                     JSON_BACKOFF_FACTOR,
+                                     m_adaptivePolling.factor);
+        }
+    }
+
+    if (adaptive.HasMember (JSON_MAX_INTERVAL))
+    {
+        if (adaptive[JSON_MAX_INTERVAL].IsInt ()
+            && adaptive[JSON_MAX_INTERVAL].GetInt () > 0)
+        {
+            m_adaptivePolling.maxInterval
+                = adaptive[JSON_MAX_INTERVAL].GetInt ();
+        }
+        else
+        {
+            Tase2Utility::log_error ("Invalid %s -> using %lu",
+                                     JSON_MAX_INTERVAL,
+                                     (unsigned long)m_adaptivePolling
+                                         .maxInterval);
+        }
+    }
+}
+
+void
+TASE2ClientConfig::m_applyPollGroups (
+    const std::unordered_map<std::string, uint64_t>& pollGroups)
+{
+    for (auto& def : m_exchangeDefinitions)
+    {
+        if (def.pollGroup.empty ())
+            continue;
+
+        auto it = pollGroups.find (def.pollGroup);
+
+        if (it == pollGroups.end ())
+        {
+            Tase2Utility::log_warn ("Unknown poll group %s for %s",
+                                    def.pollGroup.c_str (),
+                                    def.label.c_str ());
+            continue;
+        }
+
+        def.pollingInterval = it->second;
+    }
+}
+
+/* find the exchanged points among the entries of the datasets */
+void
+TASE2ClientConfig::m_resolveDatasetPoints ()
+{
+    for (const auto& pair : m_datasets)
+    {
+        const std::shared_ptr<Dataset>& dataset = pair.second;
+
+        dataset->points.clear ();
+
+        for (const auto& entry : dataset->entries)
+        {
+            // entries are either a plain name or "domain/name"
+            std::string ref = dataset->domain + ":" + entry;
+            size_t slashPos = entry.find ('/');
+
+            if (slashPos != std::string::npos)
+            {
+                ref = entry.substr (0, slashPos) + ":"
+                      + entry.substr (slashPos + 1);
+            }
+
+            auto it = m_exchangeDefinitionsRef.find (ref);
+
+            if (it != m_exchangeDefinitionsRef.end ())
+            {
+                dataset->points.push_back (it->second);
+            }
+        }
+    }
+}
+
+const std::vector<PointId>&
+TASE2ClientConfig::dstsPoints (const DatasetTransferSet& dsts) const
+{
+    static const std::vector<PointId> none;
+
+    auto it = m_datasets.find (dsts.datasetRef);
+
+    return it != m_datasets.end () ? it->second->points : none;
+}
+
+/* pass the suppression options of a DSTS on to the points of its dataset,
+ * options configured on the point itself take precedence */
+void
+TASE2ClientConfig::m_applyDstsPointOptions ()
+{
+    for (const auto& pair : m_dsTranferSets)
+    {
+        const std::shared_ptr<DatasetTransferSet>& dsts = pair.second;
+
+        if (!dsts->suppressUnchanged)
+            continue;
+
+        for (PointId id : dstsPoints (*dsts))
+        {
+            DataExchangeDefinition& def = m_exchangeDefinitions[id];
+
+            if (!def.suppressUnchangedSet)
+            {
+                def.suppressUnchanged = true;
+            }
+
+            if (def.heartbeat == 0)
+            {
+                def.heartbeat = (uint64_t)dsts->heartbeat * 1000;
+            }
+        }
+    }
+}
+
+void
+TASE2ClientConfig::m_parseExchangeConfig (const std::string& exchangeConfig)
 {
     m_exchangeConfigComplete = false;
 
@@ -848,17 +1487,95 @@ TASE2ClientConfig::importExchangeConfig (const std::string& exchangeConfig)
                 Tase2Utility::log_debug ("Add dp to Exchange Def %s",
                                          protocolRef.c_str ());
 
-                auto def = std::make_shared<DataExchangeDefinition> ();
-                def->ref = protocolRef;
-                def->label = label;
-                def->type = getDpTypeFromString (type);
+                // a reference configured twice keeps its first id, the
+                // last definition and its label replace the first one
+                auto it = m_exchangeDefinitionsRef.find (protocolRef);
+
+                PointId id;
+
+                if (it != m_exchangeDefinitionsRef.end ())
+                {
+                    id = it->second;
+
+                    Tase2Utility::log_warn (
+                        "Datapoint %s configured twice -> using label %s",
+                        protocolRef.c_str (), label.c_str ());
+
+                    auto labelIt = m_exchangeDefinitionsLabel.find (
+                        m_exchangeDefinitions[id].label);
+
+                    if (labelIt != m_exchangeDefinitionsLabel.end ()
+                        && labelIt->second == id)
+                    {
+                        m_exchangeDefinitionsLabel.erase (labelIt);
+                    }
+
+                    m_exchangeDefinitions[id] = DataExchangeDefinition ();
+                }
+                else
+                {
+                    id = (PointId)m_exchangeDefinitions.size ();
+                    m_exchangeDefinitions.emplace_back ();
+                    m_exchangeDefinitionsRef[protocolRef] = id;
+                }
 
-                m_exchangeDefinitions[label] = def;
-                m_exchangeDefinitionsRef[protocolRef] = def;
-                if (def->type < COMMAND)
+                DataExchangeDefinition& def = m_exchangeDefinitions[id];
+                def.id = id;
+                def.ref = protocolRef;
+                def.label = label;
+                def.type = getDpTypeFromString (type);
+                def.domain = protocolRef.substr (0, colonPos);
+                def.name = protocolRef.substr (colonPos + 1);
+                def.typeName = type;
+                def.converter = getValueConverter (def.type);
+                def.polled = def.type < COMMAND;
+
+                if (protocol.HasMember (JSON_SUPPRESS_UNCHANGED)
+                    && protocol[JSON_SUPPRESS_UNCHANGED].IsBool ())
                 {
-                    m_polledDatapoints[protocolRef] = def;
+                    def.suppressUnchanged
+                        = protocol[JSON_SUPPRESS_UNCHANGED].GetBool ();
+                    def.suppressUnchangedSet = true;
                 }
+
+                if (protocol.HasMember (JSON_POLLING_INTERVAL)
+                    && protocol[JSON_POLLING_INTERVAL].IsInt ()
+                    && protocol[JSON_POLLING_INTERVAL].GetInt () > 0)
+                {
+                    def.pollingInterval
+                        = protocol[JSON_POLLING_INTERVAL].GetInt ();
+                }
+
+                if (protocol.HasMember (JSON_POLL_GROUP)
+                    && protocol[JSON_POLL_GROUP].IsString ())
+                {
+                    def.pollGroup = protocol[JSON_POLL_GROUP].GetString ();
+                }
+
+                if (protocol.HasMember (JSON_DEADBAND))
+                {
+                    importDeadband (protocol, def);
+                }
+
+                if (protocol.HasMember (JSON_COALESCE_WINDOW))
+                {
+                    importCoalesce (protocol, def);
+                }
+
+                if (protocol.HasMember (JSON_AGGREGATE))
+                {
+                    importAggregate (protocol, def);
+                }
+
+                if (protocol.HasMember (JSON_HEARTBEAT)
+                    && protocol[JSON_HEARTBEAT].IsInt ()
+                    && protocol[JSON_HEARTBEAT].GetInt () > 0)
+                {
+                    def.heartbeat
+                        = (uint64_t)protocol[JSON_HEARTBEAT].GetInt () * 1000;
+                }
+
+                m_exchangeDefinitionsLabel[label] = id;
             }
             else
             {
@@ -946,13 +1663,24 @@ TASE2ClientConfig::importTlsConfig (const std::string& tlsConfig)
     }
 }
 
-std::shared_ptr<DataExchangeDefinition>
-TASE2ClientConfig::getExchangeDefinitionByRef (const std::string& ref)
+const DataExchangeDefinition*
+TASE2ClientConfig::getExchangeDefinitionByRef (const std::string& ref) const
 {
     auto it = m_exchangeDefinitionsRef.find (ref);
     if (it != m_exchangeDefinitionsRef.end ())
     {
-        return it->second;
+        return &m_exchangeDefinitions[it->second];
+    }
+    return nullptr;
+}
+
+const DataExchangeDefinition*
+TASE2ClientConfig::getExchangeDefinitionByLabel (const std::string& label) const
+{
+    auto it = m_exchangeDefinitionsLabel.find (label);
+    if (it != m_exchangeDefinitionsLabel.end ())
+    {
+        return &m_exchangeDefinitions[it->second];
     }
     return nullptr;
 }
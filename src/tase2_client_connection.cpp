@@ -1,11 +1,17 @@
 #include "tase2_client_connection.hpp"
 #include "tase2_client_config.hpp"
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
 #include <libtase2/hal_thread.h>
 #include <libtase2/tase2_client.h>
 #include <map>
+#include <set>
 #include <string>
 #include <tase2.hpp>
+#include <unistd.h>
 #include <utils.h>
 #include <vector>
 
@@ -17,10 +23,37 @@ TASE2ClientConnection::TASE2ClientConnection (TASE2Client* client,
     : m_client (client), m_config (config), m_osiParameters (osiParameters),
       m_tcpPort (tcpPort), m_serverIp (ip), m_useTls (tls)
 {
+    m_backoff.configure (m_config->reconnectDelay (),
+                         m_config->maxReconnectDelay (),
+                         m_config->reconnectJitter ());
+
+    m_pollDataSetPrefix = pollDataSetPrefix ();
 }
 
 TASE2ClientConnection::~TASE2ClientConnection () { Stop (); }
 
+/* prefix of the poll dataset names of a connection, different for every
+ * connection of every plugin instance, on this host and on others, that may
+ * create datasets on the same server. A dataset of another client is then
+ * never taken for one of ours. */
+std::string
+TASE2ClientConnection::pollDataSetPrefix ()
+{
+    static std::atomic<uint32_t> connections{ 0 };
+
+    char host[256] = { 0 };
+    gethostname (host, sizeof (host) - 1);
+
+    std::string key = std::string (host) + ":" + std::to_string (getpid ())
+                      + ":" + std::to_string (connections++);
+
+    char prefix[16];
+    snprintf (prefix, sizeof (prefix), "FP%08x",
+              (uint32_t)std::hash<std::string> () (key));
+
+    return prefix;
+}
+
 static uint64_t
 GetCurrentTimeInMs ()
 {
@@ -82,180 +115,1497 @@ TASE2ClientConnection::m_setOsiConnectionParameters ()
                                       osiParams.remoteTSelector);
 }
 
+bool
+TASE2ClientConnection::m_createDataSet (
+    const std::string& domain, const std::string& name,
+    const std::vector<std::string>& entries)
+{
+    Tase2_ClientError error;
+
+    LinkedList newDataSetEntries = LinkedList_create ();
+
+    if (newDataSetEntries == nullptr)
+    {
+        return false;
+    }
+
+    for (const auto& entry : entries)
+    {
+        Tase2Utility::log_debug ("Add datapoint %s to dataset %s:%s",
+                                 entry.c_str (), domain.c_str (),
+                                 name.c_str ());
+        char* strCopy = static_cast<char*> (malloc (entry.length () + 1));
+        if (strCopy != nullptr)
+        {
+            std::strcpy (strCopy, entry.c_str ());
+            LinkedList_add (newDataSetEntries, static_cast<void*> (strCopy));
+        }
+    }
+
+    Tase2_Client_createDataSet (m_tase2client, &error, domain.c_str (),
+                                name.c_str (), newDataSetEntries);
+
+    LinkedList_destroyDeep (newDataSetEntries, free);
+
+    if (error != TASE2_CLIENT_ERROR_OK)
+    {
+        Tase2Utility::log_error ("Error in dataset creation (Dataset "
+                                 "Name : %s, Domain : %s, Error Code : %d",
+                                 name.c_str (), domain.c_str (), error);
+        return false;
+    }
+
+    return true;
+}
+
 void
 TASE2ClientConnection::m_configDatasets ()
 {
     for (const auto& pair : m_config->getDatasets ())
     {
-        Tase2_ClientError error;
         std::shared_ptr<Dataset> dataset = pair.second;
 
         if (dataset->dynamic)
         {
             Tase2Utility::log_debug ("Create new dataset %s",
                                      dataset->datasetRef.c_str ());
-            LinkedList newDataSetEntries = LinkedList_create ();
 
-            if (newDataSetEntries == nullptr)
+            m_createDataSet (dataset->domain, dataset->datasetRef,
+                             dataset->entries);
+        }
+    }
+}
+
+/* rough size of a point value in a read response, used to keep each dataset
+ * read below the PDU size */
+static size_t
+estimateEncodedSize (const DataExchangeDefinition& def)
+{
+    size_t size = 16;
+
+    if (def.converter->hasQuality)
+        size += 8;
+
+    if (def.converter->hasTimestamp)
+        size += 12;
+
+    return size;
+}
+
+/* size of a member in the request creating a dataset, the domain specific
+ * object name "domain/name" with its tags and lengths */
+static size_t
+estimateMemberSize (const DataExchangeDefinition& def)
+{
+    return def.domain.size () + def.name.size () + 8;
+}
+
+// room for the MMS and presentation headers of a read response
+static const size_t READ_RESPONSE_OVERHEAD = 128;
+
+// room for the headers and the dataset name of a define request
+static const size_t DEFINE_REQUEST_OVERHEAD = 192;
+
+static const std::chrono::milliseconds POLL_PASS_DELAY (10);
+
+/* reads of a refresh in one pass when max_poll_reads does not limit them */
+static const size_t MAX_REFRESH_READS = 64;
+
+/* number of cycles the duration percentiles are computed over */
+static const size_t DURATION_HISTORY = 64;
+
+/* limit of an interval stretched by the overrun policy, times the interval */
+static const uint64_t MAX_INTERVAL_STRETCH = 16;
+
+/* reporting periods without a report before the points of a DSTS are polled */
+static const uint64_t DSTS_MISSED_REPORTS = 3;
+
+/* wake up period of a connected connection thread for the DSTS supervision */
+static const uint64_t CON_SUPERVISION_PERIOD = 1000;
+
+/* set up the poll units of the configured polled points, the first poll is
+ * right after connecting */
+void
+TASE2ClientConnection::m_configPollUnits ()
+{
+    uint64_t now = getMonotonicTimeInMs ();
+    size_t points = m_config->ExchangeDefinition ().size ();
+
+    m_pollWheel.reset (now);
+    m_pollCycles.clear ();
+    m_duePollUnits.clear ();
+    m_pollDataSetCount = 0;
+
+    m_polledValues.assign (points, PolledValue ());
+    m_unitOfPoint.assign (points, -1);
+
+    m_addPollUnits (m_config->polledDatapoints (), 0);
+    m_schedulePollUnits (0);
+
+    m_nextStatisticsTime = now + m_config->statisticsPeriod ();
+}
+
+/* split points into poll units. Points of the same domain and polling
+ * interval are grouped into transient datasets, so that a poll needs one
+ * read per dataset instead of one per point. A dataset is limited by the
+ * members the server accepts and by the PDU size, of the read response as
+ * well as of the request creating it. With an interval of 0 every point is
+ * polled at its own interval. */
+void
+TASE2ClientConnection::m_addPollUnits (const std::vector<PointId>& points,
+                                       uint64_t pollingInterval)
+{
+    std::map<std::pair<std::string, uint64_t>, std::vector<PointId> > groups;
+
+    for (PointId id : points)
+    {
+        const DataExchangeDefinition& def
+            = m_config->getExchangeDefinition (id);
+        uint64_t interval = pollingInterval
+                                ? pollingInterval
+                                : m_config->getPollingInterval (def);
+
+        if (interval == 0)
+            continue;
+
+        if (!m_config->bulkPolling ())
+        {
+            m_addSinglePollUnit (id, interval);
+            continue;
+        }
+
+        groups[std::make_pair (def.domain, interval)].push_back (id);
+    }
+
+    size_t maxSize = m_config->maxPduSize () - READ_RESPONSE_OVERHEAD;
+    size_t maxRequestSize = m_config->maxPduSize () - DEFINE_REQUEST_OVERHEAD;
+    size_t maxMembers = m_config->maxDataSetMembers ();
+
+    for (const auto& group : groups)
+    {
+        const std::string& domain = group.first.first;
+        uint64_t interval = group.first.second;
+        auto it = group.second.begin ();
+
+        while (it != group.second.end ())
+        {
+            PollUnit unit;
+            unit.domain = domain;
+            unit.name = m_pollDataSetPrefix + "_"
+                        + std::to_string (m_pollDataSetCount++);
+            unit.interval = interval;
+
+            std::vector<std::string> entries;
+            size_t size = 0;
+            size_t requestSize = 0;
+
+            for (; it != group.second.end (); ++it)
             {
-                continue;
+                const DataExchangeDefinition& def
+                    = m_config->getExchangeDefinition (*it);
+                size_t entrySize = estimateEncodedSize (def);
+                size_t memberSize = estimateMemberSize (def);
+
+                if (!unit.points.empty ()
+                    && (unit.points.size () >= maxMembers
+                        || size + entrySize > maxSize
+                        || requestSize + memberSize > maxRequestSize))
+                    break;
+
+                size += entrySize;
+                requestSize += memberSize;
+                unit.points.push_back (*it);
+                entries.push_back (def.domain + "/" + def.name);
+            }
+
+            Tase2_ClientError error;
+            bool created = m_createDataSet (unit.domain, unit.name, entries);
+
+            if (created)
+            {
+                unit.dataSet = Tase2_Client_getDataSet (
+                    m_tase2client, &error, unit.domain.c_str (),
+                    unit.name.c_str ());
+
+                // only datasets created by this connection are deleted
+                if (unit.dataSet == nullptr)
+                {
+                    Tase2_Client_deleteDataSet (m_tase2client, &error,
+                                                unit.domain.c_str (),
+                                                unit.name.c_str ());
+                }
             }
 
-            for (const auto& entry : dataset->entries)
+            if (unit.dataSet == nullptr)
             {
-                Tase2Utility::log_debug (
-                    "Add datapoint %s to dataset %s:%s", entry.c_str (),
-                    dataset->domain.c_str (), dataset->datasetRef.c_str ());
-                char* strCopy
-                    = static_cast<char*> (malloc (entry.length () + 1));
-                if (strCopy != nullptr)
+                Tase2Utility::log_warn (
+                    "Cannot %s poll dataset %s:%s -> polling %lu points "
+                    "one by one",
+                    created ? "get" : "create", unit.domain.c_str (),
+                    unit.name.c_str (), (unsigned long)unit.points.size ());
+
+                for (PointId id : unit.points)
                 {
-                    std::strcpy (strCopy, entry.c_str ());
-                    LinkedList_add (newDataSetEntries,
-                                    static_cast<void*> (strCopy));
+                    m_addSinglePollUnit (id, interval);
                 }
+                continue;
             }
 
-            Tase2_Client_createDataSet (
-                m_tase2client, &error, dataset->domain.c_str (),
-                dataset->datasetRef.c_str (), newDataSetEntries);
+            Tase2Utility::log_debug (
+                "Poll dataset %s:%s with %lu points every %lu ms",
+                unit.domain.c_str (), unit.name.c_str (),
+                (unsigned long)unit.points.size (), (unsigned long)interval);
+
+            m_pollUnits.push_back (std::move (unit));
+        }
+    }
+}
+
+/* schedule the poll units from first on to be read now. With the spread
+ * schedule the units of an interval are given evenly distributed phases
+ * within the interval, so that their reads don't all fall into the same
+ * pass. */
+void
+TASE2ClientConnection::m_schedulePollUnits (size_t first)
+{
+    uint64_t now = getMonotonicTimeInMs ();
+    bool spread = m_config->pollSchedule () == PollSchedule::SPREAD;
+
+    std::map<uint64_t, std::vector<uint32_t> > intervals;
+
+    for (size_t i = first; i < m_pollUnits.size (); i++)
+    {
+        intervals[m_pollUnits[i].interval].push_back ((uint32_t)i);
+    }
+
+    for (const auto& interval : intervals)
+    {
+        size_t cycleIndex = 0;
+
+        while (cycleIndex < m_pollCycles.size ()
+               && m_pollCycles[cycleIndex].interval != interval.first)
+        {
+            cycleIndex++;
+        }
+
+        if (cycleIndex == m_pollCycles.size ())
+        {
+            PollCycleStats cycle;
+            cycle.interval = interval.first;
+            cycle.effectiveInterval = interval.first;
+            cycle.cycleStart = now;
+
+            m_pollCycles.push_back (cycle);
+        }
+
+        const std::vector<uint32_t>& units = interval.second;
+
+        for (size_t k = 0; k < units.size (); k++)
+        {
+            PollUnit& unit = m_pollUnits[units[k]];
 
-            if (error != TASE2_CLIENT_ERROR_OK)
+            for (PointId id : unit.points)
             {
-                Tase2Utility::log_error (
-                    "Error in dataset creation (Dataset "
-                    "Name : %s, Domain : %s, Error Code : %d",
-                    dataset->datasetRef.c_str (), dataset->domain.c_str (),
-                    error);
+                m_unitOfPoint[id] = units[k];
             }
 
-            LinkedList_destroyDeep (newDataSetEntries, free);
+            unit.cycle = cycleIndex;
+            unit.due = now;
+
+            if (spread)
+                unit.due += interval.first * k / units.size ();
+
+            unit.scheduled = true;
+            m_pollWheel.schedule (units[k], unit.due);
         }
     }
 }
 
-/* callback handler that is called twice for each received transfer set report
- */
 void
-TASE2ClientConnection::dsTransferSetReportHandler (
-    void* parameter, bool finished, uint32_t seq,
-    Tase2_ClientDSTransferSet transferSet)
+TASE2ClientConnection::m_addSinglePollUnit (PointId id, uint64_t interval)
 {
-    if (finished)
+    PollUnit unit;
+    unit.points.push_back (id);
+    unit.interval = interval;
+
+    m_pollUnits.push_back (std::move (unit));
+}
+
+void
+TASE2ClientConnection::m_deletePollUnits ()
+{
+    for (PollUnit& unit : m_pollUnits)
     {
-        Tase2Utility::log_debug ("--> (%i) report processing finished", seq);
+        if (unit.dataSet == nullptr)
+            continue;
+
+        Tase2_ClientError error;
+
+        Tase2_ClientDataSet_destroy (unit.dataSet);
+
+        if (m_tase2client)
+        {
+            Tase2_Client_deleteDataSet (m_tase2client, &error,
+                                        unit.domain.c_str (),
+                                        unit.name.c_str ());
+        }
+    }
+
+    m_pollUnits.clear ();
+    m_pollWheel.reset (0);
+
+    m_fallbackUnits.clear ();
+    m_fallbackActive.clear ();
+}
+
+/* fingerprint of a poll unit whose values could not all be read, never
+ * taken as unchanged */
+static const uint64_t INVALID_FINGERPRINT = 0;
+
+/* mix a polled value into the fingerprint of its poll unit. For types with a
+ * timestamp the time stamp of the value itself is part of it, not the time
+ * of the poll. */
+static uint64_t
+fingerprintValue (uint64_t fingerprint, const PointUpdate& update)
+{
+    uint64_t realBits;
+    memcpy (&realBits, &update.realValue, sizeof (realBits));
+
+    const uint64_t fields[] = { (uint64_t)update.intValue, realBits,
+                                (uint64_t)update.flags,
+                                update.sourceTimestamp };
+
+    for (uint64_t field : fields)
+    {
+        fingerprint = (fingerprint ^ field) * 1099511628211ULL;
+    }
+
+    return fingerprint;
+}
+
+/* keep a polled value for refresh requests and pass it to the client */
+const PointUpdate&
+TASE2ClientConnection::m_emitPolledValue (PointId id, Tase2_PointValue value,
+                                          uint64_t timestamp)
+{
+    PolledValue& polled = m_polledValues[id];
+
+    polled.update = PointUpdate ();
+    polled.update.def = &m_config->getExchangeDefinition (id);
+    polled.update.timestamp = timestamp;
+
+    polled.update.def->converter->extract (value, polled.update);
+
+    polled.readTime = getMonotonicTimeInMs ();
+    polled.valid = true;
+
+    m_client->queueUpdate (polled.update);
+
+    return polled.update;
+}
+
+bool
+TASE2ClientConnection::m_pollPoint (PointId id, uint64_t timestamp,
+                                    uint64_t* fingerprint)
+{
+    const DataExchangeDefinition& def = m_config->getExchangeDefinition (id);
+    Tase2_ClientError error;
+
+    Tase2_PointValue value
+        = readValue (&error, def.domain.c_str (), def.name.c_str ());
+
+    if (value == nullptr)
+    {
+        Tase2Utility::log_error ("Couldn't get value for %s",
+                                 def.ref.c_str ());
+        return false;
+    }
+
+    const PointUpdate& update = m_emitPolledValue (id, value, timestamp);
+
+    if (fingerprint)
+    {
+        *fingerprint = fingerprintValue (*fingerprint, update);
+    }
+
+    Tase2_PointValue_destroy (value);
+
+    return true;
+}
+
+/* read a poll unit, returns a fingerprint of the values read or
+ * INVALID_FINGERPRINT when a read failed */
+uint64_t
+TASE2ClientConnection::m_pollUnit (const PollUnit& unit, uint64_t timestamp)
+{
+    uint64_t fingerprint = 14695981039346656037ULL;
+    bool complete = true;
+
+    if (unit.dataSet == nullptr)
+    {
+        if (!m_pollPoint (unit.points.front (), timestamp, &fingerprint))
+            return INVALID_FINGERPRINT;
+
+        return fingerprint;
+    }
+
+    Tase2_ClientError error
+        = Tase2_ClientDataSet_read (unit.dataSet, m_tase2client);
+
+    if (error != TASE2_CLIENT_ERROR_OK)
+    {
+        Tase2Utility::log_warn ("Failed to read poll dataset %s:%s (%d)",
+                                unit.domain.c_str (), unit.name.c_str (),
+                                error);
+
+        for (PointId id : unit.points)
+        {
+            if (!m_pollPoint (id, timestamp, &fingerprint))
+                complete = false;
+        }
+        return complete ? fingerprint : INVALID_FINGERPRINT;
+    }
+
+    int size = Tase2_ClientDataSet_getSize (unit.dataSet);
+
+    for (int i = 0; i < size; i++)
+    {
+        Tase2_PointValue value
+            = Tase2_ClientDataSet_getPointValue (unit.dataSet, i);
+
+        if (value == nullptr)
+        {
+            complete = false;
+            continue;
+        }
+
+        // the dataset was created from the points in this order, values
+        // stay owned by the dataset
+        if ((size_t)size == unit.points.size ())
+        {
+            const PointUpdate& update
+                = m_emitPolledValue (unit.points[i], value, timestamp);
+            fingerprint = fingerprintValue (fingerprint, update);
+        }
+        else
+        {
+            m_client->handleValue (
+                Tase2_ClientDataSet_getPointDomainName (unit.dataSet, i),
+                Tase2_ClientDataSet_getPointVariableName (unit.dataSet, i),
+                value, timestamp, false);
+
+            // not the dataset that was created, its changes can't be told
+            // apart: the unit keeps its own interval
+            complete = false;
+        }
+    }
+
+    return complete ? fingerprint : INVALID_FINGERPRINT;
+}
+
+/* a unit whose values did not change for unchanged_polls polls in a row is
+ * read less often, every time by the backoff factor up to max_interval. Any
+ * change or failed read brings it back to its own interval. */
+void
+TASE2ClientConnection::m_adaptPollUnit (PollUnit& unit, uint64_t fingerprint)
+{
+    const AdaptivePolling& adaptive = m_config->adaptivePolling ();
+
+    if (fingerprint == INVALID_FINGERPRINT)
+    {
+        unit.hasFingerprint = false;
+        unit.unchangedPolls = 0;
+        unit.backoffInterval = 0;
+        return;
+    }
+
+    if (!unit.hasFingerprint || fingerprint != unit.fingerprint)
+    {
+        if (unit.backoffInterval > 0)
+        {
+            Tase2Utility::log_debug ("Poll unit %s:%s changed -> back to %lu "
+                                     "ms",
+                                     unit.domain.c_str (), unit.name.c_str (),
+                                     (unsigned long)unit.interval);
+        }
+
+        unit.fingerprint = fingerprint;
+        unit.hasFingerprint = true;
+        unit.unchangedPolls = 0;
+        unit.backoffInterval = 0;
+        return;
+    }
+
+    if (++unit.unchangedPolls < adaptive.unchangedPolls)
+        return;
+
+    uint64_t current
+        = unit.backoffInterval > 0 ? unit.backoffInterval : unit.interval;
+    uint64_t maxInterval = std::max (adaptive.maxInterval, unit.interval);
+
+    unit.backoffInterval
+        = std::min ((uint64_t)(current * adaptive.factor), maxInterval);
+    unit.unchangedPolls = 0;
+}
+
+void
+TASE2ClientConnection::setPollingSuspended (bool suspended)
+{
+    if (m_pollingSuspended.exchange (suspended) == suspended)
+        return;
+
+    Tase2Utility::log_info ("%s:%d: %s polling", m_serverIp.c_str (),
+                            m_tcpPort, suspended ? "suspend" : "resume");
+
+    if (!suspended)
+    {
+        m_resumePolling = true;
+        m_pollCond.notify_all ();
+    }
+}
+
+/* units dropped from the wheel while polling was suspended are read right
+ * away. Called with m_pollLock held. */
+void
+TASE2ClientConnection::m_resumePollUnits ()
+{
+    uint64_t now = getMonotonicTimeInMs ();
+
+    for (size_t i = 0; i < m_pollUnits.size (); i++)
+    {
+        PollUnit& unit = m_pollUnits[i];
+
+        if (unit.active && !unit.scheduled)
+        {
+            unit.due = now;
+            unit.scheduled = true;
+            m_pollWheel.schedule ((uint32_t)i, unit.due);
+        }
+    }
+}
+
+bool
+TASE2ClientConnection::refresh (const std::vector<PointId>& points)
+{
+    if (!m_pollingEnabled)
+    {
+        return false;
+    }
+
+    uint64_t now = getMonotonicTimeInMs ();
+
+    {
+        std::lock_guard<std::mutex> lock (m_refreshLock);
+
+        for (PointId id : points)
+        {
+            m_refreshRequests.emplace_back (id, now);
+        }
+    }
+
+    m_pollCond.notify_all ();
+
+    return true;
+}
+
+/* a point is served from its last read when that ended after the request
+ * came in, so a poll in flight answers it, or is not older than the refresh
+ * TTL. The others are read, a whole poll unit at a time. A pass does at
+ * most max_poll_reads (or MAX_REFRESH_READS) reads, the rest of the request
+ * waits for the next pass so that the polling goes on in between. Called
+ * with m_pollLock held. */
+void
+TASE2ClientConnection::m_handleRefreshRequests ()
+{
+    std::vector<std::pair<PointId, uint64_t> > requests;
+
+    {
+        std::lock_guard<std::mutex> lock (m_refreshLock);
+        requests.swap (m_refreshRequests);
+    }
+
+    if (requests.empty ())
+        return;
+
+    uint64_t now = getMonotonicTimeInMs ();
+    uint64_t ttl = m_config->refreshTtl ();
+
+    size_t maxReads = MAX_REFRESH_READS;
+
+    if (m_config->maxPollReads () > 0
+        && (size_t)m_config->maxPollReads () < maxReads)
+    {
+        maxReads = m_config->maxPollReads ();
+    }
+
+    std::vector<bool> requested (m_polledValues.size (), false);
+    std::vector<PointId> cached;
+    std::vector<PointId> singles;
+    std::set<uint32_t> units;
+    std::vector<std::pair<PointId, uint64_t> > deferred;
+
+    for (const auto& request : requests)
+    {
+        PointId id = request.first;
+
+        if (id >= m_polledValues.size () || requested[id])
+            continue;
+
+        requested[id] = true;
+
+        const PolledValue& polled = m_polledValues[id];
+
+        if (polled.valid
+            && (polled.readTime >= request.second
+                || now - polled.readTime <= ttl))
+        {
+            cached.push_back (id);
+        }
+        else if (m_unitOfPoint[id] >= 0
+                 && units.count (m_unitOfPoint[id]) > 0)
+        {
+            // read with a unit of this pass already
+        }
+        else if (units.size () + singles.size () >= maxReads)
+        {
+            deferred.push_back (request);
+        }
+        else if (m_unitOfPoint[id] >= 0)
+        {
+            units.insert (m_unitOfPoint[id]);
+        }
+        else
+        {
+            singles.push_back (id);
+        }
+    }
+
+    if (!deferred.empty ())
+    {
+        std::lock_guard<std::mutex> lock (m_refreshLock);
+
+        m_refreshRequests.insert (m_refreshRequests.begin (),
+                                  deferred.begin (), deferred.end ());
+    }
+
+    Tase2Utility::log_debug ("Refresh: %lu points from cache, %lu poll units "
+                             "and %lu points to read, %lu points left for "
+                             "the next pass",
+                             (unsigned long)cached.size (),
+                             (unsigned long)units.size (),
+                             (unsigned long)singles.size (),
+                             (unsigned long)deferred.size ());
+
+    bool batched = m_client->beginReport ();
+
+    for (PointId id : cached)
+    {
+        m_client->queueUpdate (m_polledValues[id].update);
+    }
+
+    m_pollJobs.clear ();
+
+    for (uint32_t index : units)
+    {
+        PollJob job;
+        job.index = index;
+        m_pollJobs.push_back (job);
+    }
+
+    uint64_t timestamp = GetCurrentTimeInMs ();
+
+    m_runPollJobs (timestamp);
+
+    for (PointId id : singles)
+    {
+        if (!m_pollingEnabled)
+            break;
+
+        m_pollPoint (id, timestamp, nullptr);
+    }
+
+    if (batched)
+        m_client->endReport ();
+}
+
+/* poll the units that are due, all values of a pass form one report. At most
+ * max_poll_reads units are read per pass, the others stay due for the next
+ * pass so that commands are not held up behind a long series of reads.
+ * Called with m_pollLock held. */
+void
+TASE2ClientConnection::m_pollDueUnits ()
+{
+    uint64_t now = getMonotonicTimeInMs ();
+
+    m_pollWheel.advance (now, m_duePollUnits);
+
+    bool suspended = m_pollingSuspended;
+
+    // units switched off since they were scheduled leave the wheel
+    auto inactive = [this, suspended] (uint32_t index) {
+        PollUnit& unit = m_pollUnits[index];
+
+        if (unit.active && (unit.fallback || !suspended))
+            return false;
+
+        unit.scheduled = false;
+        return true;
+    };
+
+    m_duePollUnits.erase (std::remove_if (m_duePollUnits.begin (),
+                                          m_duePollUnits.end (), inactive),
+                          m_duePollUnits.end ());
+
+    if (m_duePollUnits.empty ())
+        return;
+
+    size_t reads = m_duePollUnits.size ();
+
+    if (m_config->maxPollReads () > 0
+        && reads > (size_t)m_config->maxPollReads ())
+    {
+        reads = m_config->maxPollReads ();
+    }
+
+    m_pollJobs.clear ();
+
+    for (size_t i = 0; i < reads; i++)
+    {
+        PollJob job;
+        job.index = m_duePollUnits[i];
+        m_pollJobs.push_back (job);
+
+        m_pollUnits[job.index].scheduled = false;
+    }
+
+    m_duePollUnits.erase (m_duePollUnits.begin (),
+                          m_duePollUnits.begin () + reads);
+
+    bool batched = m_client->beginReport ();
+
+    m_runPollJobs (GetCurrentTimeInMs ());
+
+    if (batched)
+        m_client->endReport ();
+
+    // bookkeeping in the order the units were due
+    for (const PollJob& job : m_pollJobs)
+    {
+        if (!job.done)
+            continue;
+
+        PollUnit& unit = m_pollUnits[job.index];
+
+        if (m_config->adaptivePolling ().enabled)
+        {
+            m_adaptPollUnit (unit, job.fingerprint);
+        }
+
+        m_updatePollCycle (unit, job.start, job.end);
+        m_reschedulePollUnit (job.index, job.end);
+    }
+}
+
+/* read the units of m_pollJobs. The poll thread takes part in the reads and
+ * returns once all of them finished. */
+void
+TASE2ClientConnection::m_runPollJobs (uint64_t timestamp)
+{
+    std::unique_lock<std::mutex> lock (m_readLock);
+
+    m_pollJobTimestamp = timestamp;
+    m_nextPollJob = 0;
+    m_pendingPollJobs = m_pollJobs.size ();
+
+    if (!m_readWorkers.empty () && m_pollJobs.size () > 1)
+    {
+        m_readCond.notify_all ();
+    }
+
+    m_workPollJobs (lock);
+
+    while (m_pendingPollJobs > 0)
+    {
+        m_readDoneCond.wait (lock);
+    }
+}
+
+/* take jobs until none is left, the reads are done without m_readLock */
+void
+TASE2ClientConnection::m_workPollJobs (std::unique_lock<std::mutex>& lock)
+{
+    while (m_nextPollJob < m_pollJobs.size ())
+    {
+        PollJob& job = m_pollJobs[m_nextPollJob++];
+        uint64_t timestamp = m_pollJobTimestamp;
+
+        lock.unlock ();
+
+        // the association is being closed, the remaining reads would fail
+        if (m_pollingEnabled)
+        {
+            job.start = getMonotonicTimeInMs ();
+            job.fingerprint = m_pollUnit (m_pollUnits[job.index], timestamp);
+            job.end = getMonotonicTimeInMs ();
+            job.done = true;
+        }
+
+        lock.lock ();
+
+        if (--m_pendingPollJobs == 0)
+        {
+            m_readDoneCond.notify_all ();
+        }
+    }
+}
+
+void
+TASE2ClientConnection::_readWorker ()
+{
+    std::unique_lock<std::mutex> lock (m_readLock);
+
+    while (m_readWorkersRunning)
+    {
+        if (m_nextPollJob < m_pollJobs.size ())
+        {
+            m_workPollJobs (lock);
+        }
+        else
+        {
+            m_readCond.wait (lock);
+        }
+    }
+}
+
+/* next read of a unit, one interval after the last one was due. When that
+ * has already passed, the read overran and the overrun policy applies. */
+void
+TASE2ClientConnection::m_reschedulePollUnit (uint32_t index, uint64_t end)
+{
+    PollUnit& unit = m_pollUnits[index];
+    PollCycleStats& cycle = m_pollCycles[unit.cycle];
+
+    // a backed off unit is not an overrun of its cycle
+    if (unit.backoffInterval > cycle.effectiveInterval)
+    {
+        unit.due = std::max (unit.due + unit.backoffInterval, end);
+        unit.scheduled = true;
+        m_pollWheel.schedule (index, unit.due);
+        return;
+    }
+
+    unit.due += cycle.effectiveInterval;
+
+    if (unit.due <= end)
+    {
+        cycle.overruns++;
+
+        switch (m_config->overrunPolicy ())
+        {
+        case OverrunPolicy::SKIP:
+            // keep the phase
+            unit.due += cycle.effectiveInterval
+                        * ((end - unit.due) / cycle.effectiveInterval + 1);
+            break;
+
+        case OverrunPolicy::CATCH_UP:
+            // overdue, expires with the next tick of the wheel
+            break;
+
+        case OverrunPolicy::STRETCH:
+            cycle.effectiveInterval
+                = std::min (cycle.effectiveInterval * 3 / 2,
+                            cycle.interval * MAX_INTERVAL_STRETCH);
+            unit.due = end + cycle.effectiveInterval;
+
+            Tase2Utility::log_warn (
+                "Poll overrun -> interval %lu ms stretched to %lu ms",
+                (unsigned long)cycle.interval,
+                (unsigned long)cycle.effectiveInterval);
+            break;
+        }
+    }
+
+    unit.scheduled = true;
+    m_pollWheel.schedule (index, unit.due);
+}
+
+void
+TASE2ClientConnection::m_sendPollStatistics (uint64_t now)
+{
+    m_nextStatisticsTime = now + m_config->statisticsPeriod ();
+
+    if (!m_pollCycles.empty ())
+    {
+        m_client->sendPollStatistics (
+            m_serverIp + ":" + std::to_string (m_tcpPort), m_pollCycles);
+    }
+}
+
+void
+TASE2ClientConnection::m_updatePollCycle (const PollUnit& unit,
+                                          uint64_t start, uint64_t end)
+{
+    PollCycleStats& cycle = m_pollCycles[unit.cycle];
+    uint64_t length = cycle.effectiveInterval;
+
+    if (start >= cycle.cycleStart + length)
+    {
+        cycle.duration = cycle.busy;
+        cycle.slack = (int64_t)length - (int64_t)cycle.busy;
+        cycle.points = cycle.pointsRead;
+        cycle.maxDuration = std::max (cycle.maxDuration, cycle.duration);
+        cycle.cycles++;
+
+        if (cycle.durations.size () < DURATION_HISTORY)
+        {
+            cycle.durations.push_back (cycle.duration);
+        }
+        else
+        {
+            cycle.durations[cycle.nextDuration] = cycle.duration;
+            cycle.nextDuration = (cycle.nextDuration + 1) % DURATION_HISTORY;
+        }
+
+        Tase2Utility::log_debug (
+            "Poll cycle %lu ms: read time %lu ms, slack %ld ms, max lateness "
+            "%lu ms",
+            (unsigned long)length, (unsigned long)cycle.duration,
+            (long)cycle.slack, (unsigned long)cycle.maxLateness);
+
+        // a stretched interval shrinks back once the reads fit easily
+        if (cycle.effectiveInterval > cycle.interval
+            && cycle.duration * 2 < cycle.effectiveInterval)
+        {
+            cycle.effectiveInterval = std::max (
+                cycle.interval,
+                cycle.effectiveInterval - cycle.effectiveInterval / 4);
+        }
+
+        cycle.cycleStart += length * ((start - cycle.cycleStart) / length);
+        cycle.busy = 0;
+        cycle.pointsRead = 0;
+    }
+
+    cycle.busy += end - start;
+    cycle.pointsRead += unit.points.size ();
+
+    if (start > unit.due)
+        cycle.maxLateness = std::max (cycle.maxLateness, start - unit.due);
+}
+
+/* called by libtase2 on every state change of the endpoint */
+void
+TASE2ClientConnection::endpointStateChangedHandler (
+    Tase2_Endpoint endpoint, void* parameter, Tase2_Endpoint_State newState)
+{
+    TASE2ClientConnection* connection
+        = static_cast<TASE2ClientConnection*> (parameter);
+
+    connection->m_signalConThread ();
+}
+
+void
+TASE2ClientConnection::m_signalConThread ()
+{
+    {
+        std::lock_guard<std::mutex> lock (m_conWaitLock);
+        m_conEvent = true;
+    }
+    m_conCond.notify_one ();
+}
+
+/* sleep until the next deadline of the current state or until woken up by an
+ * endpoint state change, Connect, Disconnect or Stop */
+void
+TASE2ClientConnection::m_waitConThread ()
+{
+    uint64_t timeout = 0; // wait for an event only
+
+    if (m_connect)
+    {
+        switch (m_connectionState)
+        {
+        case CON_STATE_IDLE:
+        case CON_STATE_CLOSED:
+            return;
+
+        case CON_STATE_CONNECTING:
+        case CON_STATE_WAIT_FOR_RECONNECT: {
+            uint64_t now = getMonotonicTimeInMs ();
+
+            if (m_delayExpirationTime <= now)
+                return;
+
+            timeout = m_delayExpirationTime - now;
+        }
+        break;
+
+        case CON_STATE_CONNECTED:
+            timeout = CON_SUPERVISION_PERIOD;
+            break;
+
+        case CON_STATE_FATAL_ERROR:
+            break;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock (m_conWaitLock);
+
+    auto woken = [this] () { return m_conEvent || !m_started; };
+
+    if (timeout > 0)
+        m_conCond.wait_for (lock, std::chrono::milliseconds (timeout), woken);
+    else
+        m_conCond.wait (lock, woken);
+
+    m_conEvent = false;
+}
+
+/* callback handler that is called twice for each received transfer set report
+ */
+void
+TASE2ClientConnection::dsTransferSetReportHandler (
+    void* parameter, bool finished, uint32_t seq,
+    Tase2_ClientDSTransferSet transferSet)
+{
+    auto connection = (TASE2ClientConnection*)parameter;
+
+    if (finished)
+    {
+        Tase2Utility::log_debug ("--> (%i) report processing finished", seq);
+
+        if (connection->m_reportBatched)
+            connection->m_client->endReport ();
+
+        connection->m_dstsReported (transferSet);
+    }
+    else
+    {
+        Tase2Utility::log_debug ("New report received with seq no: %u", seq);
+        connection->m_reportBatched = connection->m_client->beginReport ();
+    }
+}
+
+/* callback handler that is called for each data point of a received transfer
+ * set report */
+void
+TASE2ClientConnection::dsTransferSetValueHandler (
+    void* parameter, Tase2_ClientDSTransferSet transferSet,
+    const char* domainName, const char* pointName, Tase2_PointValue pointValue)
+{
+    Tase2Utility::log_debug ("  Received value for %s:%s", domainName,
+                             pointName);
+
+    auto connection = (TASE2ClientConnection*)parameter;
+
+    connection->m_client->handleValue (domainName, pointName, pointValue,
+                                       GetCurrentTimeInMs (), false);
+}
+
+void
+TASE2ClientConnection::m_configDsts (bool enabled)
+{
+    std::vector<DstsState> states;
+
+    for (const auto& pair : m_config->getDsTranferSets ())
+    {
+        DstsState state;
+        state.config = pair.second;
+        state.enabled = enabled;
+        state.ts = m_startDsts (*state.config, enabled);
+
+        uint64_t now = getMonotonicTimeInMs ();
+
+        if (state.ts)
+        {
+            state.lastReport = now;
+        }
+        else
+        {
+            // nothing is polled on a hot standby
+            state.fallback = enabled;
+            state.nextRetry = now + m_config->dstsRetryInterval ();
+        }
+
+        states.push_back (state);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (m_dstsLock);
+        m_dstsStates.swap (states);
+    }
+
+    m_fallbackChanged = true;
+}
+
+/* set up and enable a DSTS on the server, nullptr when that failed. Must not
+ * be called with m_dstsLock held, reports are handled while we wait for the
+ * responses. */
+Tase2_ClientDSTransferSet
+TASE2ClientConnection::m_startDsts (const DatasetTransferSet& config,
+                                    bool enabled)
+{
+    const DatasetTransferSet* dsts = &config;
+    Tase2_ClientError err;
+    Tase2_ClientDSTransferSet ts
+        = Tase2_Client_getNextDSTransferSet (m_tase2client, "icc1", &err);
+
+    if (!ts)
+    {
+        Tase2Utility::log_error ("GetNextDSTransferSet operation failed!");
+        return nullptr;
+    }
+
+    Tase2_ClientDataSet dataSet
+        = Tase2_Client_getDataSet (m_tase2client, &err, dsts->domain.c_str (),
+                                   dsts->datasetRef.c_str ());
+
+    if (!dataSet)
+    {
+        Tase2Utility::log_error ("Could not find dataset %s:%s",
+                                 dsts->domain.c_str (),
+                                 dsts->datasetRef.c_str ());
+        Tase2_ClientDSTransferSet_destroy (ts);
+        return nullptr;
+    }
+
+    m_datasets.push_back (dataSet);
+
+    Tase2_ClientDSTransferSet_setDataSet (ts, dataSet);
+
+    Tase2Utility::log_debug ("DSTransferSet %s:%s",
+                             Tase2_ClientDSTransferSet_getDomain (ts),
+                             Tase2_ClientDSTransferSet_getName (ts));
+
+    Tase2_ClientDSTransferSet_readValues (ts, m_tase2client);
+
+    Tase2Utility::log_debug ("  data-set: %s:%s",
+                             Tase2_ClientDSTransferSet_getDataSetDomain (ts),
+                             Tase2_ClientDSTransferSet_getDataSetName (ts));
+
+    Tase2_ClientDSTransferSet_setDataSetName (ts, dsts->domain.c_str (),
+                                              dsts->datasetRef.c_str ());
+
+    Tase2_ClientDSTransferSet_setInterval (ts, dsts->interval);
+
+    Tase2_ClientDSTransferSet_setRBE (ts, dsts->rbe);
+
+    Tase2_ClientDSTransferSet_setCritical (ts, dsts->critical);
+
+    Tase2_ClientDSTransferSet_setBufferTime (ts, dsts->bufferTime);
+
+    Tase2_ClientDSTransferSet_setIntegrityCheck (ts, dsts->integrityCheck);
+
+    Tase2_ClientDSTransferSet_setStartTime (ts, dsts->startTime);
+
+    Tase2_ClientDSTransferSet_setAllChangesReported (ts,
+                                                     dsts->allChangesReported);
+
+    Tase2_ClientDSTransferSet_setDSConditionsRequested (ts,
+                                                        dsts->dsConditions);
+
+    Tase2Utility::log_debug ("%s DSTransferSet %s",
+                             enabled ? "Start" : "Arm", dsts->dstsRef.c_str ());
+
+    Tase2_ClientDSTransferSet_setStatus (ts, enabled);
+
+    if (!Tase2_ClientDSTransferSet_writeValues (ts, m_tase2client))
+    {
+        Tase2Utility::log_error ("Failed to write dsTs values");
+        Tase2_ClientDSTransferSet_destroy (ts);
+        return nullptr;
+    }
+
+    return ts;
+}
+
+/* retry the DSTS that could not be set up and fall back to polling for the
+ * ones that stopped reporting. Runs in the connection thread, the only one
+ * that adds or removes entries of m_dstsStates. */
+void
+TASE2ClientConnection::m_superviseDsts ()
+{
+    uint64_t now = getMonotonicTimeInMs ();
+
+    for (DstsState& state : m_dstsStates)
+    {
+        if (state.ts == nullptr && now >= state.nextRetry)
+        {
+            Tase2_ClientDSTransferSet ts
+                = m_startDsts (*state.config, state.enabled);
+
+            now = getMonotonicTimeInMs ();
+
+            std::lock_guard<std::mutex> lock (m_dstsLock);
+
+            if (ts)
+            {
+                // stays polled until the first report comes in
+                Tase2Utility::log_info ("DSTS %s set up",
+                                        state.config->dstsRef.c_str ());
+                state.ts = ts;
+                state.lastReport = now;
+            }
+            else
+            {
+                state.nextRetry = now + m_config->dstsRetryInterval ();
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock (m_dstsLock);
+
+    for (DstsState& state : m_dstsStates)
+    {
+        if (state.ts == nullptr || !state.enabled)
+            continue;
+
+        // without periodic reports silence is no sign of a problem
+        uint64_t period = (uint64_t)std::max (state.config->interval,
+                                              state.config->integrityCheck)
+                          * 1000;
+
+        if (period == 0 || state.fallback)
+            continue;
+
+        if (now - state.lastReport > DSTS_MISSED_REPORTS * period)
+        {
+            Tase2Utility::log_warn ("No report from DSTS %s for %lu ms -> "
+                                    "polling its points",
+                                    state.config->dstsRef.c_str (),
+                                    (unsigned long)(now - state.lastReport));
+            state.fallback = true;
+            m_fallbackChanged = true;
+        }
+    }
+
+    if (m_fallbackChanged)
+    {
+        m_pollCond.notify_all ();
+    }
+}
+
+/* enable the DSTS armed on a hot standby, the ones that fail are polled and
+ * set up again by the supervision. Called in the connection thread. */
+void
+TASE2ClientConnection::m_enableDsts ()
+{
+    std::vector<Tase2_ClientDSTransferSet> failed;
+
+    for (DstsState& state : m_dstsStates)
+    {
+        if (state.enabled)
+            continue;
+
+        bool ok = false;
+
+        if (state.ts)
+        {
+            Tase2_ClientDSTransferSet_setStatus (state.ts, true);
+            ok = Tase2_ClientDSTransferSet_writeValues (state.ts,
+                                                        m_tase2client);
+        }
+
+        uint64_t now = getMonotonicTimeInMs ();
+
+        std::lock_guard<std::mutex> lock (m_dstsLock);
+
+        state.enabled = true;
+
+        if (ok)
+        {
+            state.lastReport = now;
+        }
+        else
+        {
+            if (state.ts)
+            {
+                Tase2Utility::log_error ("Failed to enable DSTS %s",
+                                         state.config->dstsRef.c_str ());
+                failed.push_back (state.ts);
+                state.ts = nullptr;
+            }
+            state.fallback = true;
+            state.nextRetry = now;
+        }
     }
-    else
+
+    for (Tase2_ClientDSTransferSet ts : failed)
     {
-        Tase2Utility::log_debug ("New report received with seq no: %u", seq);
+        Tase2_ClientDSTransferSet_destroy (ts);
     }
+
+    m_fallbackChanged = true;
 }
 
-/* callback handler that is called for each data point of a received transfer
- * set report */
+/* called for every report, points of a DSTS that reports again are no
+ * longer polled */
 void
-TASE2ClientConnection::dsTransferSetValueHandler (
-    void* parameter, Tase2_ClientDSTransferSet transferSet,
-    const char* domainName, const char* pointName, Tase2_PointValue pointValue)
+TASE2ClientConnection::m_dstsReported (Tase2_ClientDSTransferSet transferSet)
 {
-    Tase2Utility::log_debug ("  Received value for %s:%s", domainName,
-                             pointName);
+    std::lock_guard<std::mutex> lock (m_dstsLock);
 
-    auto connection = (TASE2ClientConnection*)parameter;
+    for (DstsState& state : m_dstsStates)
+    {
+        if (state.ts != transferSet)
+            continue;
+
+        state.lastReport = getMonotonicTimeInMs ();
 
-    connection->m_client->handleValue (
-        std::string (domainName) + ":" + std::string (pointName), pointValue,
-        GetCurrentTimeInMs (), false);
+        if (state.fallback)
+        {
+            Tase2Utility::log_info ("DSTS %s reports -> stop polling",
+                                    state.config->dstsRef.c_str ());
+            state.fallback = false;
+            m_fallbackChanged = true;
+        }
+        break;
+    }
 }
 
+/* switch the fallback poll units on or off as the DSTS states require. The
+ * units of a DSTS are created the first time they are needed and kept for
+ * the association. Called with m_pollLock held. */
 void
-TASE2ClientConnection::m_configDsts ()
+TASE2ClientConnection::m_applyDstsFallback ()
 {
-    for (const auto& pair : m_config->getDsTranferSets ())
-    {
-        std::shared_ptr<DatasetTransferSet> dsts = pair.second;
-        Tase2_ClientError err;
-        Tase2_ClientDSTransferSet ts
-            = Tase2_Client_getNextDSTransferSet (m_tase2client, "icc1", &err);
+    if (!m_fallbackChanged.exchange (false))
+        return;
 
-        if (ts)
-        {
-            Tase2_ClientDataSet dataSet = Tase2_Client_getDataSet (
-                m_tase2client, &err, dsts->domain.c_str (),
-                dsts->datasetRef.c_str ());
+    uint64_t interval = m_config->fallbackPollingInterval ();
 
-            if (!dataSet)
-            {
-                Tase2Utility::log_error ("Could not find dataset %s:%s",
-                                         dsts->domain.c_str (),
-                                         dsts->datasetRef.c_str ());
-                continue;
-            }
+    if (interval == 0)
+        return;
 
-            m_datasets.push_back (dataSet);
+    std::vector<std::shared_ptr<DatasetTransferSet> > dsts;
+    std::vector<bool> fallback;
 
-            Tase2_ClientDSTransferSet_setDataSet (ts, dataSet);
+    {
+        std::lock_guard<std::mutex> lock (m_dstsLock);
 
-            Tase2Utility::log_debug ("DSTransferSet %s:%s",
-                                     Tase2_ClientDSTransferSet_getDomain (ts),
-                                     Tase2_ClientDSTransferSet_getName (ts));
+        for (const DstsState& state : m_dstsStates)
+        {
+            dsts.push_back (state.config);
+            fallback.push_back (state.fallback);
+        }
+    }
 
-            Tase2_ClientDSTransferSet_readValues (ts, m_tase2client);
+    m_fallbackUnits.resize (dsts.size ());
+    m_fallbackActive.resize (dsts.size (), false);
 
-            Tase2Utility::log_debug (
-                "  data-set: %s:%s",
-                Tase2_ClientDSTransferSet_getDataSetDomain (ts),
-                Tase2_ClientDSTransferSet_getDataSetName (ts));
+    uint64_t now = getMonotonicTimeInMs ();
 
-            Tase2_ClientDSTransferSet_setDataSetName (
-                ts, dsts->domain.c_str (), dsts->datasetRef.c_str ());
+    for (size_t i = 0; i < dsts.size (); i++)
+    {
+        if (fallback[i] == m_fallbackActive[i])
+            continue;
 
-            Tase2_ClientDSTransferSet_setInterval (ts, dsts->interval);
+        m_fallbackActive[i] = fallback[i];
 
-            Tase2_ClientDSTransferSet_setRBE (ts, dsts->rbe);
+        if (fallback[i] && m_fallbackUnits[i].empty ())
+        {
+            std::vector<PointId> points;
 
-            Tase2_ClientDSTransferSet_setCritical (ts, dsts->critical);
+            for (PointId id : m_config->dstsPoints (*dsts[i]))
+            {
+                const DataExchangeDefinition& def
+                    = m_config->getExchangeDefinition (id);
 
-            Tase2_ClientDSTransferSet_setBufferTime (ts, dsts->bufferTime);
+                // already polled on its own
+                if (def.polled && m_config->getPollingInterval (def) > 0)
+                    continue;
 
-            Tase2_ClientDSTransferSet_setIntegrityCheck (ts, dsts->rbe);
+                points.push_back (id);
+            }
 
-            Tase2_ClientDSTransferSet_setStartTime (ts, dsts->startTime);
+            size_t first = m_pollUnits.size ();
 
-            Tase2_ClientDSTransferSet_setAllChangesReported (
-                ts, dsts->allChangesReported);
+            m_addPollUnits (points, interval);
 
-            Tase2_ClientDSTransferSet_setDSConditionsRequested (
-                ts, dsts->dsConditions);
+            for (size_t unit = first; unit < m_pollUnits.size (); unit++)
+            {
+                m_pollUnits[unit].fallback = true;
+                m_fallbackUnits[i].push_back ((uint32_t)unit);
+            }
 
-            Tase2Utility::log_debug ("Start DSTransferSet %s",
-                                     dsts->dstsRef.c_str ());
+            m_schedulePollUnits (first);
+        }
+        else
+        {
+            for (uint32_t index : m_fallbackUnits[i])
+            {
+                PollUnit& unit = m_pollUnits[index];
 
-            Tase2_ClientDSTransferSet_setStatus (ts, true);
+                unit.active = fallback[i];
 
-            if(!Tase2_ClientDSTransferSet_writeValues (ts, m_tase2client)){
-                Tase2Utility::log_error ("Failed to write dsTs values");
+                if (unit.active && !unit.scheduled)
+                {
+                    unit.due = now;
+                    unit.scheduled = true;
+                    m_pollWheel.schedule (index, unit.due);
+                }
             }
-
-            m_dsts.push_back (ts);
         }
-        else
-            Tase2Utility::log_error ("GetNextDSTransferSet operation failed!");
+
+        Tase2Utility::log_info ("%s polling the %lu points of DSTS %s",
+                                fallback[i] ? "Start" : "Stop",
+                                (unsigned long)m_config->dstsPoints (*dsts[i])
+                                    .size (),
+                                dsts[i]->dstsRef.c_str ());
     }
 }
 
+/* polls the due units while the association is up. Runs apart from the
+ * connection thread so that a long poll cycle does not delay the
+ * supervision of the endpoint state. */
 void
-TASE2ClientConnection::executePeriodicTasks ()
+TASE2ClientConnection::_pollThread ()
 {
-    uint64_t currentTime = getMonotonicTimeInMs ();
-    if (m_config->getPollingInterval () > 0
-        && currentTime >= m_nextPollingTime)
+    try
+    {
+        std::unique_lock<std::mutex> lock (m_pollLock);
+
+        while (m_started)
+        {
+            if (!m_pollingEnabled)
+            {
+                m_pollCond.wait (lock);
+                continue;
+            }
+
+            m_applyDstsFallback ();
+
+            if (m_resumePolling.exchange (false))
+            {
+                m_resumePollUnits ();
+            }
+
+            m_handleRefreshRequests ();
+            m_pollDueUnits ();
+
+            if (!m_config->statisticsAsset ().empty ())
+            {
+                uint64_t now = getMonotonicTimeInMs ();
+
+                if (now >= m_nextStatisticsTime)
+                {
+                    m_sendPollStatistics (now);
+                }
+            }
+
+            m_pollCond.wait_for (lock, POLL_PASS_DELAY);
+        }
+    }
+    catch (const std::exception& e)
     {
-        m_client->handleAllValues ();
-        m_nextPollingTime = currentTime + m_config->getPollingInterval ();
+        Tase2Utility::log_error ("Exception caught in _pollThread: %s",
+                                 e.what ());
     }
 }
 
+/* the steps of the state machine run with m_conLock held, Disconnect from
+ * another thread waits for the current one to finish */
 void
 TASE2ClientConnection::_conThread ()
 {
@@ -264,6 +1614,8 @@ TASE2ClientConnection::_conThread ()
         while (m_started)
         {
             {
+                std::lock_guard<std::mutex> lock (m_conLock);
+
                 if (m_connect)
                 {
                     Tase2_Endpoint_State newState;
@@ -271,27 +1623,31 @@ TASE2ClientConnection::_conThread ()
                     {
                     case CON_STATE_IDLE: {
 
+                        if (getMonotonicTimeInMs () < m_nextConnectTime)
+                        {
+                            m_delayExpirationTime = m_nextConnectTime;
+                            m_connectionState = CON_STATE_WAIT_FOR_RECONNECT;
+                            break;
+                        }
+
                         if (m_endpoint != nullptr)
                         {
-                            {
-                                std::lock_guard<std::mutex> lock (m_conLock);
-                                Tase2_Endpoint_destroy (m_endpoint);
-                                m_endpoint = nullptr;
-                            }
+                            Tase2_Endpoint_destroy (m_endpoint);
+                            m_endpoint = nullptr;
                         }
 
                         if (prepareConnection ())
                         {
                             Tase2_ClientError error;
-                            {
-                                std::lock_guard<std::mutex> lock (m_conLock);
-                                m_connectionState = CON_STATE_CONNECTING;
-                                m_connecting = true;
-                                m_delayExpirationTime
-                                    = getMonotonicTimeInMs () + 10000;
-                                if (m_osiParameters)
-                                    m_setOsiConnectionParameters ();
-                            }
+
+                            m_connectionState = CON_STATE_CONNECTING;
+                            m_connecting = true;
+                            m_connectAttempts++;
+                            m_delayExpirationTime
+                                = getMonotonicTimeInMs ()
+                                  + m_config->connectTimeout ();
+                            if (m_osiParameters)
+                                m_setOsiConnectionParameters ();
 
                             Tase2_Client_connectEx (m_tase2client);
 
@@ -306,19 +1662,12 @@ TASE2ClientConnection::_conThread ()
                                 Tase2Utility::log_error (
                                     "Failed to connect to %s:%d",
                                     m_serverIp.c_str (), m_tcpPort);
-                                {
-                                    std::lock_guard<std::mutex> lock (
-                                        m_conLock);
-                                    m_connectionState = CON_STATE_FATAL_ERROR;
-                                }
+                                m_connectionState = CON_STATE_FATAL_ERROR;
                             }
                         }
                         else
                         {
-                            {
-                                std::lock_guard<std::mutex> lock (m_conLock);
-                                m_connectionState = CON_STATE_FATAL_ERROR;
-                            }
+                            m_connectionState = CON_STATE_FATAL_ERROR;
                             Tase2Utility::log_error (
                                 "Fatal configuration error");
                         }
@@ -329,65 +1678,86 @@ TASE2ClientConnection::_conThread ()
                         newState = Tase2_Endpoint_getState (m_endpoint);
                         if (newState == TASE2_ENDPOINT_STATE_CONNECTED)
                         {
-                            {
-                                std::lock_guard<std::mutex> lock (m_conLock);
-                                m_configDatasets ();
-                                m_configDsts ();
-                                Tase2_Client_installDSTransferSetReportHandler (
-                                    m_tase2client, dsTransferSetReportHandler,
-                                    nullptr);
-                                Tase2_Client_installDSTransferSetValueHandler (
-                                    m_tase2client, dsTransferSetValueHandler,
-                                    this);
-                                Tase2Utility::log_info ("Connected to %s:%d",
-                                                        m_serverIp.c_str (),
-                                                        m_tcpPort);
-                                m_connectionState = CON_STATE_CONNECTED;
-                                m_connecting = false;
-                                m_connected = true;
-                            }
+                            if (m_active)
+                                m_setupAssociation ();
+                            else if (m_armed)
+                                m_armAssociation ();
+                            Tase2_Client_installDSTransferSetReportHandler (
+                                m_tase2client, dsTransferSetReportHandler,
+                                this);
+                            Tase2_Client_installDSTransferSetValueHandler (
+                                m_tase2client, dsTransferSetValueHandler,
+                                this);
+                            Tase2Utility::log_info ("Connected to %s:%d",
+                                                    m_serverIp.c_str (),
+                                                    m_tcpPort);
+                            m_connectionState = CON_STATE_CONNECTED;
+                            m_connecting = false;
+                            m_connected = true;
+                            m_connectSucceeded ();
+                            m_client->connectionStateChanged ();
+                        }
+                        else if (newState == TASE2_ENDPOINT_STATE_ERROR
+                                 || newState == TASE2_ENDPOINT_STATE_IDLE)
+                        {
+                            // refused or closed, try again after the backoff
+                            Tase2Utility::log_warn (
+                                "Failed to connect to %s:%d",
+                                m_serverIp.c_str (), m_tcpPort);
+                            m_connectFailed ();
+                            cleanUp ();
+                            m_connecting = false;
+                            m_delayExpirationTime = m_nextConnectTime;
+                            m_connectionState = CON_STATE_WAIT_FOR_RECONNECT;
+                            m_client->connectionStateChanged ();
                         }
                         else if (getMonotonicTimeInMs ()
                                  > m_delayExpirationTime)
                         {
-                            std::lock_guard<std::mutex> lock (m_conLock);
                             Tase2Utility::log_warn (
                                 "Timeout while connecting %d", m_tcpPort);
-                            Disconnect ();
+                            m_connectFailed ();
+                            m_closeConnection ();
+                            m_client->connectionStateChanged ();
                         }
                         break;
 
-                    case CON_STATE_CONNECTED: {
-                        std::lock_guard<std::mutex> lock (m_conLock);
+                    case CON_STATE_CONNECTED:
                         newState = Tase2_Endpoint_getState (m_endpoint);
                         if (newState != TASE2_ENDPOINT_STATE_CONNECTED)
                         {
                             cleanUp ();
                             m_connectionState = CON_STATE_IDLE;
+                            m_connected = false;
+                            m_connectFailed ();
+                            m_client->connectionStateChanged ();
+                        }
+                        else if (m_active && !m_associationReady)
+                        {
+                            m_setupAssociation ();
+                        }
+                        else if (m_armed && !m_associationArmed)
+                        {
+                            m_armAssociation ();
                         }
                         else
                         {
-                            executePeriodicTasks ();
+                            m_superviseDsts ();
                         }
-                    }
-                    break;
+                        break;
 
-                    case CON_STATE_CLOSED: {
-                        std::lock_guard<std::mutex> lock (m_conLock);
-                        m_delayExpirationTime
-                            = getMonotonicTimeInMs () + 10000;
+                    case CON_STATE_CLOSED:
+                        m_connectFailed ();
+                        m_delayExpirationTime = m_nextConnectTime;
                         m_connectionState = CON_STATE_WAIT_FOR_RECONNECT;
-                    }
-                    break;
+                        break;
 
-                    case CON_STATE_WAIT_FOR_RECONNECT: {
-                        std::lock_guard<std::mutex> lock (m_conLock);
+                    case CON_STATE_WAIT_FOR_RECONNECT:
                         if (getMonotonicTimeInMs () >= m_delayExpirationTime)
                         {
                             m_connectionState = CON_STATE_IDLE;
                         }
-                    }
-                    break;
+                        break;
 
                     case CON_STATE_FATAL_ERROR:
                         break;
@@ -395,7 +1765,7 @@ TASE2ClientConnection::_conThread ()
                 }
             }
 
-            Thread_sleep (50);
+            m_waitConThread ();
         }
         {
             std::lock_guard<std::mutex> lock (m_conLock);
@@ -418,18 +1788,137 @@ TASE2ClientConnection::Start ()
 
         m_conThread
             = new std::thread (&TASE2ClientConnection::_conThread, this);
+        m_pollThread
+            = new std::thread (&TASE2ClientConnection::_pollThread, this);
+
+        // the poll thread does one of the reads itself
+        m_readWorkersRunning = true;
+
+        for (int i = 1; i < m_config->maxOutstandingReads (); i++)
+        {
+            m_readWorkers.push_back (
+                new std::thread (&TASE2ClientConnection::_readWorker, this));
+        }
+    }
+}
+
+/* set up what the active (or polling only) connection needs on the
+ * association: datasets, DSTS and the poll units. Called with m_conLock held.
+ */
+void
+TASE2ClientConnection::m_setupAssociation ()
+{
+    if (m_associationArmed)
+    {
+        if (!m_pollingOnly)
+            m_enableDsts ();
+    }
+    else if (!m_pollingOnly)
+    {
+        m_configDatasets ();
+        m_configDsts (true);
+    }
+    {
+        std::lock_guard<std::mutex> pollLock (m_pollLock);
+        m_configPollUnits ();
+        m_pollingEnabled = true;
+    }
+    m_pollCond.notify_all ();
+
+    m_associationReady = true;
+}
+
+/* datasets and disabled DSTS of a hot standby. Called with m_conLock held. */
+void
+TASE2ClientConnection::m_armAssociation ()
+{
+    m_configDatasets ();
+    m_configDsts (false);
+
+    Tase2Utility::log_info ("%s:%d armed as hot standby", m_serverIp.c_str (),
+                            m_tcpPort);
+
+    m_associationArmed = true;
+}
+
+/* a connect attempt failed or the association was lost, the next attempt
+ * waits for the backoff delay */
+void
+TASE2ClientConnection::m_connectFailed ()
+{
+    uint64_t now = getMonotonicTimeInMs ();
+    uint64_t delay = m_backoff.next ();
+
+    if (m_disconnectedSince == 0)
+        m_disconnectedSince = now;
+
+    m_nextConnectTime = now + delay;
+
+    Tase2Utility::log_info ("%s:%d: next connect attempt in %lu ms",
+                            m_serverIp.c_str (), m_tcpPort,
+                            (unsigned long)delay);
+}
+
+void
+TASE2ClientConnection::m_connectSucceeded ()
+{
+    uint64_t timeToReconnect = 0;
+
+    if (m_disconnectedSince != 0)
+    {
+        timeToReconnect = getMonotonicTimeInMs () - m_disconnectedSince;
+        m_disconnectedSince = 0;
+        m_reconnects++;
+
+        Tase2Utility::log_info ("%s:%d: reconnected after %u failed "
+                                "attempts (%lu ms)",
+                                m_serverIp.c_str (), m_tcpPort,
+                                m_backoff.failures (),
+                                (unsigned long)timeToReconnect);
     }
+
+    m_backoff.reset ();
+    m_nextConnectTime = 0;
+
+    m_client->sendConnectionStatistics (
+        m_serverIp + ":" + std::to_string (m_tcpPort), m_connectAttempts,
+        m_reconnects, timeToReconnect);
+}
+
+void
+TASE2ClientConnection::Activate ()
+{
+    m_armed = false;
+    m_active = true;
+    m_signalConThread ();
+}
+
+void
+TASE2ClientConnection::Arm ()
+{
+    m_armed = true;
+    m_signalConThread ();
 }
 
 void
 TASE2ClientConnection::cleanUp ()
 {
-    if (!m_dsts.empty ())
+    // a new association has to be chosen as the active one again
+    m_active = false;
+    m_associationReady = false;
+    m_associationArmed = false;
+
     {
-        for (const auto& entry : m_dsts)
+        std::lock_guard<std::mutex> lock (m_dstsLock);
+
+        for (const DstsState& state : m_dstsStates)
         {
-            Tase2_ClientDSTransferSet_destroy (entry);
+            if (state.ts)
+            {
+                Tase2_ClientDSTransferSet_destroy (state.ts);
+            }
         }
+        m_dstsStates.clear ();
     }
     if (!m_datasets.empty ())
     {
@@ -437,7 +1926,16 @@ TASE2ClientConnection::cleanUp ()
         {
             Tase2_ClientDataSet_destroy (entry);
         }
+        m_datasets.clear ();
+    }
+
+    // stop polling before the client goes away, waits for the running read
+    m_pollingEnabled = false;
+    {
+        std::lock_guard<std::mutex> lock (m_pollLock);
+        m_deletePollUnits ();
     }
+
     if (!m_connDataSetDirectoryPairs.empty ())
     {
         for (const auto& entry : m_connDataSetDirectoryPairs)
@@ -463,11 +1961,7 @@ TASE2ClientConnection::cleanUp ()
         m_tase2client = nullptr;
     }
 
-    if (m_tlsConfig != nullptr)
-    {
-        TLSConfiguration_destroy (m_tlsConfig);
-    }
-    m_tlsConfig = nullptr;
+    m_tlsContext.reset ();
 }
 
 void
@@ -480,6 +1974,28 @@ TASE2ClientConnection::Stop ()
         std::lock_guard<std::mutex> lock (m_conLock);
         m_started = false;
     }
+    m_signalConThread ();
+    {
+        std::lock_guard<std::mutex> lock (m_pollLock);
+        m_pollCond.notify_all ();
+    }
+    if (m_pollThread)
+    {
+        m_pollThread->join ();
+        delete m_pollThread;
+        m_pollThread = nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock (m_readLock);
+        m_readWorkersRunning = false;
+        m_readCond.notify_all ();
+    }
+    for (std::thread* worker : m_readWorkers)
+    {
+        worker->join ();
+        delete worker;
+    }
+    m_readWorkers.clear ();
     if (m_conThread)
     {
         m_conThread->join ();
@@ -493,179 +2009,20 @@ TASE2ClientConnection::prepareConnection ()
 {
     if (UseTLS ())
     {
-        TLSConfiguration tlsConfig = TLSConfiguration_create ();
-
-        bool tlsConfigOk = true;
-
-        std::string certificateStore
-            = getDataDir () + std::string ("/etc/certs/");
-        std::string certificateStorePem
-            = getDataDir () + std::string ("/etc/certs/pem/");
-
-        if (m_config->GetOwnCertificate ().length () == 0
-            || m_config->GetPrivateKey ().length () == 0)
-        {
-            Tase2Utility::log_error (
-                "No private key and/or certificate configured for client");
-            tlsConfigOk = false;
-        }
-        else
-        {
-            std::string privateKeyFile
-                = certificateStore + m_config->GetPrivateKey ();
-
-            if (access (privateKeyFile.c_str (), R_OK) == 0)
-            {
-                if (TLSConfiguration_setOwnKeyFromFile (
-                        tlsConfig, privateKeyFile.c_str (), nullptr)
-                    == false)
-                {
-                    Tase2Utility::log_error (
-                        "Failed to load private key file: %s",
-                        privateKeyFile.c_str ());
-                    tlsConfigOk = false;
-                }
-            }
-            else
-            {
-                Tase2Utility::log_error (
-                    "Failed to access private key file: %s",
-                    privateKeyFile.c_str ());
-                tlsConfigOk = false;
-            }
-
-            std::string clientCert = m_config->GetOwnCertificate ();
-            bool isPemClientCertificate
-                = clientCert.rfind (".pem") == clientCert.size () - 4;
-
-            std::string clientCertFile;
-
-            if (isPemClientCertificate)
-                clientCertFile = certificateStorePem + clientCert;
-            else
-                clientCertFile = certificateStore + clientCert;
-
-            if (access (clientCertFile.c_str (), R_OK) == 0)
-            {
-                if (TLSConfiguration_setOwnCertificateFromFile (
-                        tlsConfig, clientCertFile.c_str ())
-                    == false)
-                {
-                    Tase2Utility::log_error (
-                        "Failed to load client certificate file: %s",
-                        clientCertFile.c_str ());
-                    tlsConfigOk = false;
-                }
-            }
-            else
-            {
-                Tase2Utility::log_error (
-                    "Failed to access client certificate file: %s",
-                    clientCertFile.c_str ());
-                tlsConfigOk = false;
-            }
-        }
-
-        if (!m_config->GetRemoteCertificates ().empty ())
-        {
-            TLSConfiguration_setAllowOnlyKnownCertificates (tlsConfig, true);
-
-            for (const std::string& remoteCert :
-                 m_config->GetRemoteCertificates ())
-            {
-                bool isPemRemoteCertificate
-                    = remoteCert.rfind (".pem") == remoteCert.size () - 4;
-
-                std::string remoteCertFile;
-
-                if (isPemRemoteCertificate)
-                    remoteCertFile = certificateStorePem + remoteCert;
-                else
-                    remoteCertFile = certificateStore + remoteCert;
-
-                if (access (remoteCertFile.c_str (), R_OK) == 0)
-                {
-                    if (TLSConfiguration_addAllowedCertificateFromFile (
-                            tlsConfig, remoteCertFile.c_str ())
-                        == false)
-                    {
-                        Tase2Utility::log_warn (
-                            "Failed to load remote certificate file: %s -> "
-                            "ignore certificate",
-                            remoteCertFile.c_str ());
-                    }
-                }
-                else
-                {
-                    Tase2Utility::log_warn (
-                        "Failed to access remote certificate file: %s -> "
-                        "ignore certificate",
-                        remoteCertFile.c_str ());
-                }
-            }
-        }
-        else
-        {
-            TLSConfiguration_setAllowOnlyKnownCertificates (tlsConfig, false);
-        }
-
-        if (m_config->GetCaCertificates ().size () > 0)
-        {
-            TLSConfiguration_setChainValidation (tlsConfig, true);
-
-            for (const std::string& caCert : m_config->GetCaCertificates ())
-            {
-                bool isPemCaCertificate
-                    = caCert.rfind (".pem") == caCert.size () - 4;
-
-                std::string caCertFile;
-
-                if (isPemCaCertificate)
-                    caCertFile = certificateStorePem + caCert;
-                else
-                    caCertFile = certificateStore + caCert;
-
-                if (access (caCertFile.c_str (), R_OK) == 0)
-                {
-                    if (TLSConfiguration_addCACertificateFromFile (
-                            tlsConfig, caCertFile.c_str ())
-                        == false)
-                    {
-                        Tase2Utility::log_warn (
-                            "Failed to load CA certificate file: %s -> ignore "
-                            "certificate",
-                            caCertFile.c_str ());
-                    }
-                }
-                else
-                {
-                    Tase2Utility::log_warn (
-                        "Failed to access CA certificate file: %s -> ignore "
-                        "certificate",
-                        caCertFile.c_str ());
-                }
-            }
-        }
-        else
-        {
-            TLSConfiguration_setChainValidation (tlsConfig, false);
-        }
+        // credentials are loaded once and shared by all connections
+        std::shared_ptr<TLSContext> tlsContext = m_client->tlsContext ();
 
-        if (tlsConfigOk)
+        if (tlsContext)
         {
-
-            TLSConfiguration_setRenegotiationTime (tlsConfig, 60000);
-
-            m_endpoint = Tase2_Endpoint_create (tlsConfig, m_passive);
+            m_endpoint = Tase2_Endpoint_create (tlsContext->get (), m_passive);
 
             if (m_endpoint)
             {
-                m_tlsConfig = tlsConfig;
+                m_tlsContext = tlsContext;
             }
             else
             {
                 Tase2Utility::log_error ("TLS configuration failed");
-                TLSConfiguration_destroy (tlsConfig);
             }
         }
         else
@@ -696,6 +2053,10 @@ TASE2ClientConnection::prepareConnection ()
     }
 
     m_setOsiConnectionParameters ();
+
+    Tase2_Endpoint_setStateChangedHandler (
+        m_endpoint, endpointStateChangedHandler, this);
+
     m_tase2client = Tase2_Client_createEx (m_endpoint);
 
     return m_tase2client != nullptr;
@@ -703,10 +2064,41 @@ TASE2ClientConnection::prepareConnection ()
 
 void
 TASE2ClientConnection::Disconnect ()
+{
+    {
+        std::lock_guard<std::mutex> lock (m_conLock);
+        m_closeConnection ();
+    }
+    m_signalConThread ();
+}
+
+/* the client stopped waiting for this connection. An attempt still in
+ * progress counts as failed, so the next Connect waits for the backoff. */
+void
+TASE2ClientConnection::GiveUp ()
+{
+    {
+        std::lock_guard<std::mutex> lock (m_conLock);
+
+        if (m_connectionState == CON_STATE_CONNECTING)
+        {
+            m_connectFailed ();
+        }
+        m_closeConnection ();
+    }
+    m_signalConThread ();
+}
+
+/* close the association and stay idle until the next Connect. The time of
+ * the next connect attempt is kept, a Connect right after still waits for
+ * the backoff. Called with m_conLock held. */
+void
+TASE2ClientConnection::m_closeConnection ()
 {
     m_connecting = false;
     m_connected = false;
     m_connect = false;
+    m_armed = false;
     m_connectionState = CON_STATE_IDLE;
     cleanUp ();
 }
@@ -715,6 +2107,7 @@ void
 TASE2ClientConnection::Connect ()
 {
     m_connect = true;
+    m_signalConThread ();
 }
 
 Tase2_PointValue
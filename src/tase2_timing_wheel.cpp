@@ -0,0 +1,123 @@
+#include "tase2_timing_wheel.hpp"
+
+TimingWheel::TimingWheel (uint64_t tickMs) : m_tickMs (tickMs ? tickMs : 1)
+{
+}
+
+void
+TimingWheel::reset (uint64_t now)
+{
+    for (auto& level : m_slots)
+    {
+        for (auto& slot : level)
+        {
+            slot.clear ();
+        }
+    }
+
+    m_currentTick = now / m_tickMs;
+    m_size = 0;
+}
+
+void
+TimingWheel::schedule (uint32_t id, uint64_t due)
+{
+    // round up, a timer never expires early
+    Timer timer{ id, (due + m_tickMs - 1) / m_tickMs };
+
+    // the current tick has been handled, overdue timers expire with the next
+    if (timer.due <= m_currentTick)
+    {
+        timer.due = m_currentTick + 1;
+    }
+
+    m_insert (timer);
+    m_size++;
+}
+
+void
+TimingWheel::m_insert (const Timer& timer)
+{
+    uint64_t due = timer.due;
+    uint64_t delta = due - m_currentTick;
+
+    int level = 0;
+
+    while (level < LEVELS - 1 && delta >= (SLOTS << (SLOT_BITS * level)))
+    {
+        level++;
+    }
+
+    // beyond the range of the wheel: park in the farthest slot, the timer
+    // is inserted again when that slot is cascaded
+    if (delta >= (SLOTS << (SLOT_BITS * level)))
+    {
+        due = m_currentTick + (SLOTS << (SLOT_BITS * level)) - 1;
+    }
+
+    size_t slot = (due >> (SLOT_BITS * level)) & SLOT_MASK;
+
+    m_slots[level][slot].push_back (timer);
+}
+
+void
+TimingWheel::m_cascade (int level)
+{
+    size_t slot = (m_currentTick >> (SLOT_BITS * level)) & SLOT_MASK;
+
+    std::vector<Timer> timers;
+    timers.swap (m_slots[level][slot]);
+
+    for (const Timer& timer : timers)
+    {
+        m_insert (timer);
+    }
+}
+
+void
+TimingWheel::advance (uint64_t now, std::vector<uint32_t>& expired)
+{
+    uint64_t target = now / m_tickMs;
+
+    while (m_currentTick < target)
+    {
+        // nothing scheduled, skip the idle ticks
+        if (m_size == 0)
+        {
+            m_currentTick = target;
+            break;
+        }
+
+        m_currentTick++;
+
+        // move the timers of the next coarser slot down when a level wraps
+        for (int level = 1; level < LEVELS; level++)
+        {
+            if ((m_currentTick & ((1ULL << (SLOT_BITS * level)) - 1)) != 0)
+                break;
+
+            m_cascade (level);
+        }
+
+        std::vector<Timer>& slot = m_slots[0][m_currentTick & SLOT_MASK];
+
+        if (slot.empty ())
+            continue;
+
+        std::vector<Timer> timers;
+        timers.swap (slot);
+
+        for (const Timer& timer : timers)
+        {
+            if (timer.due <= m_currentTick)
+            {
+                expired.push_back (timer.id);
+                m_size--;
+            }
+            else
+            {
+                m_insert (timer);
+            }
+        }
+    }
+}
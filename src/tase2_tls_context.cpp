@@ -0,0 +1,239 @@
+#include "tase2_tls_context.hpp"
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utils.h>
+
+TLSContextCache::File
+TLSContextCache::m_stat (const std::string& path)
+{
+    File file;
+    struct stat st;
+
+    file.path = path;
+
+    if (stat (path.c_str (), &st) == 0)
+    {
+        file.exists = true;
+        file.mtime = st.st_mtime;
+        file.size = st.st_size;
+        file.inode = st.st_ino;
+    }
+
+    return file;
+}
+
+bool
+TLSContextCache::m_changed () const
+{
+    for (const File& file : m_files)
+    {
+        File now = m_stat (file.path);
+
+        if (now.exists != file.exists || now.mtime != file.mtime
+            || now.size != file.size || now.inode != file.inode)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::shared_ptr<TLSContext>
+TLSContextCache::get ()
+{
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    if (m_context && !m_changed ())
+        return m_context;
+
+    if (m_context)
+    {
+        Tase2Utility::log_info ("TLS credentials changed -> reloading");
+    }
+
+    // endpoints still using the old context keep it until they are destroyed
+    m_context = m_load ();
+
+    return m_context;
+}
+
+static bool
+isPemFile (const std::string& file)
+{
+    return file.rfind (".pem") == file.size () - 4;
+}
+
+std::shared_ptr<TLSContext>
+TLSContextCache::m_load ()
+{
+    m_files.clear ();
+
+    TLSConfiguration tlsConfig = TLSConfiguration_create ();
+
+    bool tlsConfigOk = true;
+
+    std::string certificateStore = getDataDir () + std::string ("/etc/certs/");
+    std::string certificateStorePem
+        = getDataDir () + std::string ("/etc/certs/pem/");
+
+    if (m_config->GetOwnCertificate ().length () == 0
+        || m_config->GetPrivateKey ().length () == 0)
+    {
+        Tase2Utility::log_error (
+            "No private key and/or certificate configured for client");
+        tlsConfigOk = false;
+    }
+    else
+    {
+        std::string privateKeyFile
+            = certificateStore + m_config->GetPrivateKey ();
+
+        m_files.push_back (m_stat (privateKeyFile));
+
+        if (access (privateKeyFile.c_str (), R_OK) == 0)
+        {
+            if (TLSConfiguration_setOwnKeyFromFile (
+                    tlsConfig, privateKeyFile.c_str (), nullptr)
+                == false)
+            {
+                Tase2Utility::log_error ("Failed to load private key file: %s",
+                                         privateKeyFile.c_str ());
+                tlsConfigOk = false;
+            }
+        }
+        else
+        {
+            Tase2Utility::log_error ("Failed to access private key file: %s",
+                                     privateKeyFile.c_str ());
+            tlsConfigOk = false;
+        }
+
+        std::string clientCert = m_config->GetOwnCertificate ();
+
+        std::string clientCertFile;
+
+        if (isPemFile (clientCert))
+            clientCertFile = certificateStorePem + clientCert;
+        else
+            clientCertFile = certificateStore + clientCert;
+
+        m_files.push_back (m_stat (clientCertFile));
+
+        if (access (clientCertFile.c_str (), R_OK) == 0)
+        {
+            if (TLSConfiguration_setOwnCertificateFromFile (
+                    tlsConfig, clientCertFile.c_str ())
+                == false)
+            {
+                Tase2Utility::log_error (
+                    "Failed to load client certificate file: %s",
+                    clientCertFile.c_str ());
+                tlsConfigOk = false;
+            }
+        }
+        else
+        {
+            Tase2Utility::log_error (
+                "Failed to access client certificate file: %s",
+                clientCertFile.c_str ());
+            tlsConfigOk = false;
+        }
+    }
+
+    if (!m_config->GetRemoteCertificates ().empty ())
+    {
+        TLSConfiguration_setAllowOnlyKnownCertificates (tlsConfig, true);
+
+        for (const std::string& remoteCert :
+             m_config->GetRemoteCertificates ())
+        {
+            std::string remoteCertFile;
+
+            if (isPemFile (remoteCert))
+                remoteCertFile = certificateStorePem + remoteCert;
+            else
+                remoteCertFile = certificateStore + remoteCert;
+
+            m_files.push_back (m_stat (remoteCertFile));
+
+            if (access (remoteCertFile.c_str (), R_OK) == 0)
+            {
+                if (TLSConfiguration_addAllowedCertificateFromFile (
+                        tlsConfig, remoteCertFile.c_str ())
+                    == false)
+                {
+                    Tase2Utility::log_warn (
+                        "Failed to load remote certificate file: %s -> "
+                        "ignore certificate",
+                        remoteCertFile.c_str ());
+                }
+            }
+            else
+            {
+                Tase2Utility::log_warn (
+                    "Failed to access remote certificate file: %s -> "
+                    "ignore certificate",
+                    remoteCertFile.c_str ());
+            }
+        }
+    }
+    else
+    {
+        TLSConfiguration_setAllowOnlyKnownCertificates (tlsConfig, false);
+    }
+
+    if (m_config->GetCaCertificates ().size () > 0)
+    {
+        TLSConfiguration_setChainValidation (tlsConfig, true);
+
+        for (const std::string& caCert : m_config->GetCaCertificates ())
+        {
+            std::string caCertFile;
+
+            if (isPemFile (caCert))
+                caCertFile = certificateStorePem + caCert;
+            else
+                caCertFile = certificateStore + caCert;
+
+            m_files.push_back (m_stat (caCertFile));
+
+            if (access (caCertFile.c_str (), R_OK) == 0)
+            {
+                if (TLSConfiguration_addCACertificateFromFile (
+                        tlsConfig, caCertFile.c_str ())
+                    == false)
+                {
+                    Tase2Utility::log_warn (
+                        "Failed to load CA certificate file: %s -> ignore "
+                        "certificate",
+                        caCertFile.c_str ());
+                }
+            }
+            else
+            {
+                Tase2Utility::log_warn (
+                    "Failed to access CA certificate file: %s -> ignore "
+                    "certificate",
+                    caCertFile.c_str ());
+            }
+        }
+    }
+    else
+    {
+        TLSConfiguration_setChainValidation (tlsConfig, false);
+    }
+
+    if (!tlsConfigOk)
+    {
+        // not cached, the files are tried again with the next connect
+        TLSConfiguration_destroy (tlsConfig);
+        m_files.clear ();
+        return nullptr;
+    }
+
+    TLSConfiguration_setRenegotiationTime (tlsConfig, 60000);
+
+    return std::make_shared<TLSContext> (tlsConfig);
+}
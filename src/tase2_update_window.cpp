@@ -0,0 +1,153 @@
+#include "tase2_update_window.hpp"
+
+void
+UpdateWindows::reset (size_t points)
+{
+    m_windows.assign (points, Window ());
+
+    while (!m_deadlines.empty ())
+    {
+        m_deadlines.pop ();
+    }
+}
+
+void
+UpdateWindows::add (const PointUpdate& update, uint64_t now, Output& out)
+{
+    const DataExchangeDefinition* def = update.def;
+
+    if (def->id >= m_windows.size ())
+    {
+        out.push_back (update);
+    }
+    else if (def->aggregateWindow > 0)
+    {
+        m_aggregate (m_windows[def->id], update, now, out);
+    }
+    else if (def->coalesceWindow > 0)
+    {
+        m_coalesce (m_windows[def->id], update, now, out);
+    }
+    else
+    {
+        out.push_back (update);
+    }
+}
+
+void
+UpdateWindows::m_coalesce (Window& window, const PointUpdate& update,
+                           uint64_t now, Output& out)
+{
+    const DataExchangeDefinition* def = update.def;
+
+    // quality changes are never held back, ingest what we have and restart
+    if (window.open && update.flags != window.flags)
+    {
+        m_close (window, out);
+        window.flags = update.flags;
+        out.push_back (update);
+        return;
+    }
+
+    window.flags = update.flags;
+
+    if (!window.open)
+    {
+        m_open (window, def->id, def->coalesceWindow, now);
+
+        if (def->coalesceMode == CoalesceMode::FIRST_LAST)
+        {
+            out.push_back (update);
+            return;
+        }
+    }
+
+    window.pending = update;
+    window.hasPending = true;
+}
+
+void
+UpdateWindows::m_aggregate (Window& window, const PointUpdate& update,
+                            uint64_t now, Output& out)
+{
+    const DataExchangeDefinition* def = update.def;
+
+    // values of different quality are not aggregated together
+    if (window.open && update.flags != window.flags)
+    {
+        m_close (window, out);
+    }
+
+    if (!window.open)
+    {
+        m_open (window, def->id, def->aggregateWindow, now);
+    }
+
+    window.flags = update.flags;
+    window.pending = update;
+    window.hasPending = true;
+    window.stats.add (update.realValue);
+}
+
+void
+UpdateWindows::expire (uint64_t now, Output& out)
+{
+    while (!m_deadlines.empty () && m_deadlines.top ().first <= now)
+    {
+        Deadline deadline = m_deadlines.top ();
+        m_deadlines.pop ();
+
+        Window& window = m_windows[deadline.second];
+
+        // stale entry of a window that was closed early
+        if (!window.open || window.deadline != deadline.first)
+            continue;
+
+        m_close (window, out);
+    }
+}
+
+void
+UpdateWindows::flush (Output& out)
+{
+    for (Window& window : m_windows)
+    {
+        if (window.open)
+        {
+            m_close (window, out);
+        }
+    }
+
+    while (!m_deadlines.empty ())
+    {
+        m_deadlines.pop ();
+    }
+}
+
+void
+UpdateWindows::m_open (Window& window, PointId id, uint64_t duration,
+                       uint64_t now)
+{
+    window.open = true;
+    window.deadline = now + duration;
+    m_deadlines.push (Deadline (window.deadline, id));
+}
+
+void
+UpdateWindows::m_close (Window& window, Output& out)
+{
+    if (window.hasPending)
+    {
+        out.push_back (window.pending);
+
+        if (window.stats.count > 0)
+        {
+            out.back ().aggregate = true;
+            out.back ().stats = window.stats;
+        }
+    }
+
+    window.open = false;
+    window.hasPending = false;
+    window.stats = AggregateStats ();
+}
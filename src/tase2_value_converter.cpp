@@ -0,0 +1,268 @@
+#include "tase2_value_converter.hpp"
+#include <type_traits>
+
+/*
+ * Per type properties. The generic template covers the data point types
+ * that carry no value (DP_TYPE_UNKNOWN), every known type specialises it.
+ */
+template <DPTYPE T> struct DpTypeTraits
+{
+    static constexpr const char* name = "";
+    static constexpr bool hasValue = false;
+    static constexpr bool isReal = false;
+    static constexpr bool hasQuality = false;
+    static constexpr bool hasTimestamp = false;
+
+    static int64_t
+    getValue (Tase2_PointValue)
+    {
+        return 0;
+    }
+};
+
+#define DP_TYPE_TRAITS(TYPE, NAME, VALUE_TYPE, GETTER, QUALITY, TIMESTAMP)    \
+    template <> struct DpTypeTraits<TYPE>                                     \
+    {                                                                         \
+        static constexpr const char* name = NAME;                             \
+        static constexpr bool hasValue = true;                                \
+        static constexpr bool isReal = std::is_floating_point<VALUE_TYPE>::value; \
+        static constexpr bool hasQuality = QUALITY;                           \
+        static constexpr bool hasTimestamp = TIMESTAMP;                       \
+                                                                              \
+        static VALUE_TYPE                                                     \
+        getValue (Tase2_PointValue value)                                     \
+        {                                                                     \
+            return GETTER (value);                                            \
+        }                                                                     \
+    }
+
+DP_TYPE_TRAITS (REAL, "Real", double, Tase2_PointValue_getValueReal, false,
+                false);
+DP_TYPE_TRAITS (REALQ, "RealQ", double, Tase2_PointValue_getValueReal, true,
+                false);
+DP_TYPE_TRAITS (REALQTIME, "RealQTime", double, Tase2_PointValue_getValueReal,
+                true, true);
+DP_TYPE_TRAITS (REALQTIMEEXT, "RealQTimeExt", double,
+                Tase2_PointValue_getValueReal, true, true);
+DP_TYPE_TRAITS (STATE, "State", int64_t, Tase2_PointValue_getValueState,
+                false, false);
+DP_TYPE_TRAITS (STATEQ, "StateQ", int64_t, Tase2_PointValue_getValueState,
+                true, false);
+DP_TYPE_TRAITS (STATEQTIME, "StateQTime", int64_t,
+                Tase2_PointValue_getValueState, true, true);
+DP_TYPE_TRAITS (STATEQTIMEEXT, "StateQTimeExt", int64_t,
+                Tase2_PointValue_getValueState, true, true);
+DP_TYPE_TRAITS (DISCRETE, "Discrete", int64_t,
+                Tase2_PointValue_getValueDiscrete, false, false);
+DP_TYPE_TRAITS (DISCRETEQ, "DiscreteQ", int64_t,
+                Tase2_PointValue_getValueDiscrete, true, false);
+DP_TYPE_TRAITS (DISCRETEQTIME, "DiscreteQTime", int64_t,
+                Tase2_PointValue_getValueDiscrete, true, true);
+DP_TYPE_TRAITS (DISCRETEQTIMEEXT, "DiscreteQTimeExt", int64_t,
+                Tase2_PointValue_getValueDiscrete, true, true);
+DP_TYPE_TRAITS (STATESUP, "StateSup", int64_t,
+                Tase2_PointValue_getValueStateSupplemental, false, false);
+DP_TYPE_TRAITS (STATESUPQ, "StateSupQ", int64_t,
+                Tase2_PointValue_getValueStateSupplemental, true, false);
+DP_TYPE_TRAITS (STATESUPQTIME, "StateSupQTime", int64_t,
+                Tase2_PointValue_getValueStateSupplemental, true, true);
+DP_TYPE_TRAITS (STATESUPQTIMEEXT, "StateSupQTimeExt", int64_t,
+                Tase2_PointValue_getValueStateSupplemental, true, true);
+DP_TYPE_TRAITS (COMMAND, "Command", int64_t,
+                Tase2_PointValue_getValueDiscrete, false, false);
+DP_TYPE_TRAITS (SETPOINTREAL, "SetPointReal", double,
+                Tase2_PointValue_getValueReal, false, false);
+DP_TYPE_TRAITS (SETPOINTDISCRETE, "SetPointDiscrete", int64_t,
+                Tase2_PointValue_getValueDiscrete, false, false);
+
+#undef DP_TYPE_TRAITS
+
+template <class T>
+static Datapoint*
+createDatapoint (const std::string& dataname, const T& value)
+{
+    DatapointValue dp_value = DatapointValue (value);
+    return new Datapoint (dataname, dp_value);
+}
+
+static std::string
+validityToString (Tase2_DataFlags flags)
+{
+    if (flags | TASE2_DATA_FLAGS_VALIDITY_VALID)
+    {
+        return "valid";
+    }
+    else if (flags | TASE2_DATA_FLAGS_VALIDITY_HELD)
+    {
+        return "held";
+    }
+    else if (flags | TASE2_DATA_FLAGS_VALIDITY_SUSPECT)
+    {
+        return "suspect";
+    }
+    else if (flags | TASE2_DATA_FLAGS_VALIDITY_NOTVALID)
+    {
+        return "invalid";
+    }
+    return "";
+}
+
+static std::string
+currentSourceToString (Tase2_DataFlags flags)
+{
+    if (flags | TASE2_DATA_FLAGS_CURRENT_SOURCE_TELEMETERED)
+    {
+        return "telemetered";
+    }
+    else if (flags | TASE2_DATA_FLAGS_CURRENT_SOURCE_ENTERED)
+    {
+        return "entered";
+    }
+    else if (flags | TASE2_DATA_FLAGS_CURRENT_SOURCE_CALCULATED)
+    {
+        return "calculated";
+    }
+    else if (flags | TASE2_DATA_FLAGS_CURRENT_SOURCE_ESTIMATED)
+    {
+        return "estimated";
+    }
+    return "";
+}
+
+static std::string
+normalValueToString (Tase2_DataFlags flags)
+{
+    if (flags | TASE2_DATA_FLAGS_NORMAL_VALUE)
+    {
+        return "normal";
+    }
+    return "abnormal";
+}
+
+/* the traits are compile time constants, so the branches below on them are
+ * removed from every specialisation that does not need them */
+
+static void
+setValue (PointUpdate& update, double value)
+{
+    update.realValue = value;
+}
+
+static void
+setValue (PointUpdate& update, int64_t value)
+{
+    update.intValue = value;
+}
+
+template <DPTYPE T>
+static void
+extractValue (Tase2_PointValue value, PointUpdate& update)
+{
+    typedef DpTypeTraits<T> Traits;
+
+    if (Traits::hasValue)
+    {
+        setValue (update, Traits::getValue (value));
+    }
+
+    if (Traits::hasQuality)
+    {
+        update.flags = Tase2_PointValue_getFlags (value);
+    }
+
+    if (Traits::hasTimestamp)
+    {
+        update.sourceTimestamp = Tase2_PointValue_getTimeStamp (value);
+    }
+}
+
+template <DPTYPE T>
+static Datapoint*
+createDataObject (const PointUpdate& update)
+{
+    typedef DpTypeTraits<T> Traits;
+
+    const DataExchangeDefinition* def = update.def;
+
+    auto datapoints = new std::vector<Datapoint*>;
+
+    datapoints->reserve (3 + (Traits::hasValue ? 1 : 0)
+                         + (Traits::hasQuality ? 3 : 0)
+                         + (Traits::hasTimestamp ? 2 : 0));
+
+    datapoints->push_back (createDatapoint ("do_type", def->typeName));
+    datapoints->push_back (createDatapoint ("do_domain", def->domain));
+    datapoints->push_back (createDatapoint ("do_name", def->name));
+
+    if (Traits::hasValue)
+    {
+        if (Traits::isReal)
+            datapoints->push_back (
+                createDatapoint ("do_value", (double)update.realValue));
+        else
+            datapoints->push_back (
+                createDatapoint ("do_value", (int64_t)update.intValue));
+    }
+
+    if (Traits::hasQuality)
+    {
+        Tase2_DataFlags flags = update.flags;
+        datapoints->push_back (
+            createDatapoint ("do_validity", validityToString (flags)));
+        datapoints->push_back (
+            createDatapoint ("do_cs", currentSourceToString (flags)));
+        datapoints->push_back (createDatapoint ("do_quality_normal_value",
+                                                normalValueToString (flags)));
+    }
+
+    if (Traits::hasTimestamp)
+    {
+        datapoints->push_back (
+            createDatapoint ("do_ts", (long)update.timestamp));
+        datapoints->push_back (createDatapoint ("do_ts_validity", "valid"));
+    }
+
+    DatapointValue dpv (datapoints, true);
+
+    return new Datapoint ("data_object", dpv);
+}
+
+#define CONVERTER(TYPE)                                                       \
+    {                                                                         \
+        DpTypeTraits<TYPE>::name, DpTypeTraits<TYPE>::isReal,                 \
+            DpTypeTraits<TYPE>::hasQuality, DpTypeTraits<TYPE>::hasTimestamp, \
+            extractValue<TYPE>, createDataObject<TYPE>                        \
+    }
+
+// indexed by DPTYPE, keep in enum order
+static const ValueConverter converters[] = {
+    CONVERTER (REAL),          CONVERTER (REALQ),
+    CONVERTER (REALQTIME),     CONVERTER (REALQTIMEEXT),
+    CONVERTER (STATE),         CONVERTER (STATEQ),
+    CONVERTER (STATEQTIME),    CONVERTER (STATEQTIMEEXT),
+    CONVERTER (DISCRETE),      CONVERTER (DISCRETEQ),
+    CONVERTER (DISCRETEQTIME), CONVERTER (DISCRETEQTIMEEXT),
+    CONVERTER (STATESUP),      CONVERTER (STATESUPQ),
+    CONVERTER (STATESUPQTIME), CONVERTER (STATESUPQTIMEEXT),
+    CONVERTER (COMMAND),       CONVERTER (SETPOINTREAL),
+    CONVERTER (SETPOINTDISCRETE)
+};
+
+static const ValueConverter unknownConverter = CONVERTER (DP_TYPE_UNKNOWN);
+
+#undef CONVERTER
+
+static_assert (sizeof (converters) / sizeof (converters[0])
+                   == SETPOINTDISCRETE + 1,
+               "one converter per DPTYPE");
+
+const ValueConverter*
+getValueConverter (DPTYPE type)
+{
+    if (type < 0 || type > SETPOINTDISCRETE)
+    {
+        return &unknownConverter;
+    }
+
+    return &converters[type];
+}
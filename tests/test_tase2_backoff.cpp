@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include <tase2_backoff.hpp>
+
+TEST (ReconnectBackoffTest, DoublesUpToMaximum)
+{
+    ReconnectBackoff backoff (1000, 5000, 0.0);
+
+    ASSERT_EQ (1000, backoff.next ());
+    ASSERT_EQ (2000, backoff.next ());
+    ASSERT_EQ (4000, backoff.next ());
+    ASSERT_EQ (5000, backoff.next ());
+    ASSERT_EQ (5000, backoff.next ());
+    ASSERT_EQ (5u, backoff.failures ());
+
+    backoff.reset ();
+
+    ASSERT_EQ (1000, backoff.next ());
+}
+
+TEST (ReconnectBackoffTest, JitterStaysInRange)
+{
+    ReconnectBackoff backoff (1000, 1000, 0.2);
+
+    bool varied = false;
+    uint64_t first = backoff.next ();
+
+    for (int i = 0; i < 100; i++)
+    {
+        uint64_t delay = backoff.next ();
+
+        ASSERT_GE (delay, 800u);
+        ASSERT_LE (delay, 1200u);
+
+        if (delay != first)
+            varied = true;
+    }
+
+    ASSERT_TRUE (varied);
+}
@@ -5,8 +5,14 @@
 #include <string.h>
 #include <tase2.hpp>
 
+#include <arpa/inet.h>
 #include <boost/thread.hpp>
+#include <functional>
 #include <libtase2/hal_thread.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
 #include <utility>
 #include <vector>
 
@@ -91,11 +97,204 @@ static string protocol_config_2 = QUOTE ({
     }
 });
 
+static string protocol_config_backoff = QUOTE ({
+    "protocol_stack" : {
+        "name" : "tase2client",
+        "version" : "0.0.1",
+        "transport_layer" : {
+            "connections" : [ {
+                "ip_addr" : "127.0.0.1",
+                "port" : 10004,
+                "osi" : {
+                    "local_ap_title" : "1.1.1.998",
+                    "local_ae_qualifier" : 12,
+                    "remote_ap_title" : "1.1.1.999",
+                    "remote_ae_qualifier" : 12
+                },
+                "tls" : false
+            } ],
+            "connectTimeout" : 10000,
+            "reconnectDelay" : 200,
+            "maxReconnectDelay" : 800,
+            "reconnectJitter" : 0.0
+        },
+        "application_layer" : { "polling_interval" : 0 }
+    }
+});
+
+static string protocol_config_standby = QUOTE ({
+    "protocol_stack" : {
+        "name" : "tase2client",
+        "version" : "0.0.1",
+        "transport_layer" : {
+            "connections" : [
+                {
+                    "ip_addr" : "127.0.0.1",
+                    "port" : 10002,
+                    "osi" : {
+                        "local_ap_title" : "1.1.1.998",
+                        "local_ae_qualifier" : 12,
+                        "remote_ap_title" : "1.1.1.999",
+                        "remote_ae_qualifier" : 12
+                    },
+                    "tls" : false
+                },
+                {
+                    "ip_addr" : "127.0.0.1",
+                    "port" : 10003,
+                    "osi" : {
+                        "local_ap_title" : "1.1.1.996",
+                        "local_ae_qualifier" : 12,
+                        "remote_ap_title" : "1.1.1.997",
+                        "remote_ae_qualifier" : 12
+                    },
+                    "tls" : false
+                }
+            ]
+        },
+        "application_layer" : {
+            "polling_interval" : 500,
+            "poll_on_standby" : true
+        }
+    }
+});
+
+static string protocol_config_grace = QUOTE ({
+    "protocol_stack" : {
+        "name" : "tase2client",
+        "version" : "0.0.1",
+        "transport_layer" : {
+            "connections" : [
+                {
+                    "ip_addr" : "127.0.0.1",
+                    "port" : 10002,
+                    "osi" : {
+                        "local_ap_title" : "1.1.1.998",
+                        "local_ae_qualifier" : 12,
+                        "remote_ap_title" : "1.1.1.999",
+                        "remote_ae_qualifier" : 12
+                    },
+                    "tls" : false
+                },
+                {
+                    "ip_addr" : "127.0.0.1",
+                    "port" : 10003,
+                    "osi" : {
+                        "local_ap_title" : "1.1.1.996",
+                        "local_ae_qualifier" : 12,
+                        "remote_ap_title" : "1.1.1.997",
+                        "remote_ae_qualifier" : 12
+                    },
+                    "tls" : false
+                }
+            ],
+            "backupTimeout" : 5000,
+            "connectGraceWindow" : 1000,
+            "connectTimeout" : 10000
+        },
+        "application_layer" : { "polling_interval" : 0 }
+    }
+});
+
+static string protocol_config_hot = QUOTE ({
+    "protocol_stack" : {
+        "name" : "tase2client",
+        "version" : "0.0.1",
+        "transport_layer" : {
+            "connections" : [
+                {
+                    "ip_addr" : "127.0.0.1",
+                    "port" : 10002,
+                    "osi" : {
+                        "local_ap_title" : "1.1.1.998",
+                        "local_ae_qualifier" : 12,
+                        "remote_ap_title" : "1.1.1.999",
+                        "remote_ae_qualifier" : 12
+                    },
+                    "tls" : false
+                },
+                {
+                    "ip_addr" : "127.0.0.1",
+                    "port" : 10003,
+                    "osi" : {
+                        "local_ap_title" : "1.1.1.996",
+                        "local_ae_qualifier" : 12,
+                        "remote_ap_title" : "1.1.1.997",
+                        "remote_ae_qualifier" : 12
+                    },
+                    "tls" : false
+                }
+            ],
+            "hotStandby" : true
+        },
+        "application_layer" : {
+            "polling_interval" : 0,
+            "datasets" : [ {
+                "domain" : "icc1",
+                "dataset_ref" : "DataSet1",
+                "entries" : [ "icc1/datapointReal" ],
+                "dynamic" : false
+            } ],
+            "dataset_transfer_sets" : [ {
+                "domain" : "icc1",
+                "name" : "dsts1",
+                "dataset_ref" : "DataSet1",
+                "dsConditions" : [ "interval" ],
+                "startTime" : 0,
+                "interval" : 1,
+                "bufTm" : 0,
+                "integrityCheck" : 60,
+                "critical" : false,
+                "rbe" : false,
+                "allChangesReported" : true
+            } ]
+        }
+    }
+});
+
 // PLUGIN DEFAULT EXCHANGED DATA CONF
 
+static string protocol_config_statistics = QUOTE ({
+    "protocol_stack" : {
+        "name" : "tase2client",
+        "version" : "0.0.1",
+        "transport_layer" : {
+            "connections" : [ {
+                "ip_addr" : "127.0.0.1",
+                "port" : 10002,
+                "osi" : {
+                    "local_ap_title" : "1.1.1.998",
+                    "local_ae_qualifier" : 12,
+                    "remote_ap_title" : "1.1.1.999",
+                    "remote_ae_qualifier" : 12
+                },
+                "tls" : false
+            } ]
+        },
+        "application_layer" : {
+            "polling_interval" : 0,
+            "statistics_asset" : "tase2_statistics"
+        }
+    }
+});
+
 static string exchanged_data
     = QUOTE ({ "exchanged_data" : { "datapoints" : [] } });
 
+static string exchanged_data_1 = QUOTE ({
+    "exchanged_data" : {
+        "datapoints" : [ {
+            "pivot_id" : "TS1",
+            "label" : "TS1",
+            "protocols" : [ {
+                "name" : "tase2",
+                "ref" : "icc1:datapointReal",
+                "typeid" : "Real"
+            } ]
+        } ]
+    }
+});
+
 // PLUGIN DEFAULT TLS CONF
 static string tls_config = QUOTE ({
     "tls_conf" : {
@@ -122,6 +321,7 @@ class ConnectionHandlingTest : public testing::Test
     Reading* storedReading = nullptr;
     int clockSyncHandlerCalled = 0;
     std::vector<Reading*> storedReadings;
+    std::thread::id ingestThread;
 
     int asduHandlerCalled = 0;
     Tase2_Endpoint lastConnection = nullptr;
@@ -232,6 +432,108 @@ class ConnectionHandlingTest : public testing::Test
         return nullptr;
     }
 
+    /* a server with the point icc1:datapointReal, and with the dataset
+     * DataSet1 of it and the DSTS dsts1 when withDsts is set */
+    struct TestServer
+    {
+        Tase2_DataModel model = nullptr;
+        Tase2_Endpoint endpoint = nullptr;
+        Tase2_Server server = nullptr;
+    };
+
+    static TestServer
+    createServer (int port, const char* apTitle, const char* clientApTitle,
+                  bool withDsts = false, TLSConfiguration tlsConfig = nullptr)
+    {
+        TestServer test;
+
+        test.model = Tase2_DataModel_create ();
+
+        Tase2_Domain icc = Tase2_DataModel_addDomain (test.model, "icc1");
+
+        Tase2_BilateralTable blt
+            = Tase2_BilateralTable_create ("blt1", icc, clientApTitle, 12);
+
+        test.endpoint = Tase2_Endpoint_create (tlsConfig, true);
+
+        Tase2_Endpoint_setLocalIpAddress (test.endpoint, "0.0.0.0");
+        Tase2_Endpoint_setLocalTcpPort (test.endpoint, port);
+        Tase2_Endpoint_setLocalApTitle (test.endpoint, apTitle, 12);
+
+        Tase2_IndicationPoint datapointReal = Tase2_Domain_addIndicationPoint (
+            icc, "datapointReal", TASE2_IND_POINT_TYPE_REAL, TASE2_NO_QUALITY,
+            TASE2_NO_TIMESTAMP, false, true);
+
+        if (withDsts)
+        {
+            Tase2_Domain_addDSTransferSet (icc, "dsts1");
+
+            Tase2_DataSet dataSet = Tase2_Domain_addDataSet (icc, "DataSet1");
+            Tase2_DataSet_addEntry (dataSet, icc, "datapointReal");
+        }
+
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointReal, true, false);
+
+        test.server = Tase2_Server_createEx (test.model, test.endpoint);
+
+        Tase2_Server_addBilateralTable (test.server, blt);
+
+        Tase2_Server_start (test.server);
+
+        return test;
+    }
+
+    static void
+    destroyServer (TestServer& test)
+    {
+        Tase2_Endpoint_destroy (test.endpoint);
+        Tase2_Server_stop (test.server);
+        Tase2_Server_destroy (test.server);
+        Tase2_DataModel_destroy (test.model);
+    }
+
+    /* accepts TCP connections on port but never answers, a client
+     * connecting there stays in CONNECTING. -1 on error */
+    static int
+    createSilentListener (int port)
+    {
+        int fd = socket (AF_INET, SOCK_STREAM, 0);
+
+        if (fd == -1)
+            return -1;
+
+        int reuse = 1;
+        setsockopt (fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof (reuse));
+
+        struct sockaddr_in addr;
+        memset (&addr, 0, sizeof (addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons (port);
+        addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+
+        if (bind (fd, (struct sockaddr*)&addr, sizeof (addr)) == -1
+            || listen (fd, 4) == -1)
+        {
+            close (fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+    static bool
+    waitFor (std::function<bool ()> condition, int ms)
+    {
+        for (int waited = 0; !condition (); waited += 10)
+        {
+            if (waited >= ms)
+                return false;
+            Thread_sleep (10);
+        }
+        return true;
+    }
+
     static void
     ingestCallback (void* parameter, Reading reading)
     {
@@ -251,6 +553,8 @@ class ConnectionHandlingTest : public testing::Test
 
         self->storedReadings.push_back (self->storedReading);
 
+        self->ingestThread = std::this_thread::get_id ();
+
         self->ingestCallbackCalled++;
     }
 };
@@ -562,4 +866,517 @@ TEST_F (ConnectionHandlingTest, TwoConnectionsBackup)
     Tase2_Server_destroy (server2);
     Tase2_DataModel_destroy (model1);
     Tase2_DataModel_destroy (model2);
-}
\ No newline at end of file
+}
+
+TEST_F (ConnectionHandlingTest, ConnectFailureBackoff)
+{
+    tase2->setJsonConfig (protocol_config_backoff, exchanged_data,
+                          tls_config);
+
+    // no server yet, every attempt is refused
+    tase2->start ();
+
+    Thread_sleep (2000);
+
+    TASE2ClientConnection* connection
+        = tase2->m_client->m_connections->front ();
+
+    uint64_t nextConnectTime = 0;
+    {
+        std::lock_guard<std::mutex> lock (connection->m_conLock);
+
+        // refused long before the connect timeout, delays of 200, 400 and
+        // 800 ms
+        ASSERT_GE (connection->m_backoff.failures (), 3);
+        ASSERT_GE (connection->m_connectAttempts, 3);
+        ASSERT_LE (connection->m_connectAttempts, 6);
+        ASSERT_NE (connection->m_disconnectedSince, 0);
+        nextConnectTime = connection->m_nextConnectTime;
+    }
+    ASSERT_NE (nextConnectTime, 0);
+
+    // the next attempt still waits for the backoff
+    connection->Disconnect ();
+    {
+        std::lock_guard<std::mutex> lock (connection->m_conLock);
+        ASSERT_GE (connection->m_nextConnectTime, nextConnectTime);
+        ASSERT_GE (connection->m_backoff.failures (), 3);
+    }
+
+    Tase2_DataModel model = Tase2_DataModel_create ();
+
+    Tase2_Domain icc = Tase2_DataModel_addDomain (model, "icc1");
+
+    Tase2_BilateralTable blt
+        = Tase2_BilateralTable_create ("blt1", icc, "1.1.1.998", 12);
+
+    Tase2_Endpoint endpoint = Tase2_Endpoint_create (nullptr, true);
+
+    Tase2_Endpoint_setLocalIpAddress (endpoint, "0.0.0.0");
+    Tase2_Endpoint_setLocalTcpPort (endpoint, 10004);
+
+    Tase2_Endpoint_setLocalApTitle (endpoint, "1.1.1.999", 12);
+
+    Tase2_Server server = Tase2_Server_createEx (model, endpoint);
+
+    Tase2_Server_addBilateralTable (server, blt);
+
+    Tase2_Server_start (server);
+
+    auto start = std::chrono::high_resolution_clock::now ();
+    auto timeout = std::chrono::seconds (10);
+    while (!tase2->m_client->m_active_connection
+           || !tase2->m_client->m_active_connection->Connected ())
+    {
+        auto now = std::chrono::high_resolution_clock::now ();
+        if (now - start > timeout)
+        {
+            Tase2_Endpoint_destroy (endpoint);
+            Tase2_Server_stop (server);
+            Tase2_Server_destroy (server);
+            Tase2_DataModel_destroy (model);
+            FAIL () << "Connection not established within timeout";
+            break;
+        }
+        Thread_sleep (10);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (connection->m_conLock);
+        ASSERT_EQ (connection->m_backoff.failures (), 0);
+        ASSERT_EQ (connection->m_nextConnectTime, 0);
+        ASSERT_EQ (connection->m_disconnectedSince, 0);
+        ASSERT_EQ (connection->m_reconnects, 1);
+    }
+
+    tase2->stop ();
+    Tase2_Endpoint_destroy (endpoint);
+    Tase2_Server_stop (server);
+    Tase2_Server_destroy (server);
+    Tase2_DataModel_destroy (model);
+}
+
+TEST_F (ConnectionHandlingTest, StandbyPolling)
+{
+    tase2->setJsonConfig (protocol_config_standby, exchanged_data_1,
+                          tls_config);
+
+    TestServer server1 = createServer (10002, "1.1.1.999", "1.1.1.998");
+    TestServer server2 = createServer (10003, "1.1.1.997", "1.1.1.996");
+
+    tase2->start ();
+
+    TASE2Client* client = tase2->m_client;
+
+    // the first server is the active one, the second polls
+    bool standbyUp = waitFor (
+        [client] () {
+            std::lock_guard<std::mutex> lock (client->m_activeConnectionMtx);
+            return client->m_active_connection
+                   && client->m_active_connection->Connected ()
+                   && client->m_standby_connection
+                   && client->m_standby_connection->Connected ()
+                   && client->m_standby_connection->Active ();
+        },
+        10000);
+
+    if (!standbyUp)
+    {
+        destroyServer (server1);
+        destroyServer (server2);
+        FAIL () << "Standby not polling within timeout";
+    }
+
+    TASE2ClientConnection* active = client->m_active_connection;
+    TASE2ClientConnection* standby = client->m_standby_connection;
+
+    ASSERT_EQ (active->m_tcpPort, 10002);
+    ASSERT_EQ (standby->m_tcpPort, 10003);
+    ASSERT_TRUE (standby->m_pollingOnly);
+    ASSERT_TRUE (waitFor (
+        [active] () { return active->m_pollingSuspended.load (); }, 2000));
+
+    // the values come in over the standby
+    int count = ingestCallbackCalled;
+    ASSERT_TRUE (
+        waitFor ([&] () { return ingestCallbackCalled >= count + 2; }, 3000));
+
+    // the standby is lost -> the active connection polls again
+    Tase2_Server_stop (server2.server);
+
+    ASSERT_TRUE (waitFor ([active] () { return !active->m_pollingSuspended; },
+                          5000));
+
+    count = ingestCallbackCalled;
+    ASSERT_TRUE (
+        waitFor ([&] () { return ingestCallbackCalled >= count + 2; }, 3000));
+
+    {
+        std::lock_guard<std::mutex> lock (client->m_activeConnectionMtx);
+        ASSERT_EQ (client->m_active_connection, active);
+    }
+
+    tase2->stop ();
+    destroyServer (server1);
+    destroyServer (server2);
+}
+
+TEST_F (ConnectionHandlingTest, ParallelDialPriority)
+{
+    tase2->setJsonConfig (protocol_config_grace, exchanged_data, tls_config);
+
+    TestServer server1 = createServer (10002, "1.1.1.999", "1.1.1.998");
+    TestServer server2 = createServer (10003, "1.1.1.997", "1.1.1.996");
+
+    tase2->start ();
+
+    TASE2Client* client = tase2->m_client;
+
+    bool active = waitFor (
+        [client] () {
+            std::lock_guard<std::mutex> lock (client->m_activeConnectionMtx);
+            return client->m_active_connection
+                   && client->m_active_connection->Active ();
+        },
+        10000);
+
+    if (!active)
+    {
+        destroyServer (server1);
+        destroyServer (server2);
+        FAIL () << "No active connection within timeout";
+    }
+
+    // both connect at about the same time, the first configured one wins
+    {
+        std::lock_guard<std::mutex> lock (client->m_activeConnectionMtx);
+        ASSERT_EQ (client->m_active_connection->m_tcpPort, 10002);
+    }
+
+    // without standby the other connection is closed
+    TASE2ClientConnection* other = client->m_connections->back ();
+
+    ASSERT_TRUE (waitFor (
+        [other] () { return !other->Connected () && !other->Connecting (); },
+        2000));
+
+    tase2->stop ();
+    destroyServer (server1);
+    destroyServer (server2);
+}
+
+TEST_F (ConnectionHandlingTest, ParallelDialGraceWindow)
+{
+    tase2->setJsonConfig (protocol_config_grace, exchanged_data, tls_config);
+
+    // the first server never answers, its connection keeps connecting
+    int silent = createSilentListener (10002);
+    ASSERT_NE (silent, -1);
+
+    TestServer server2 = createServer (10003, "1.1.1.997", "1.1.1.996");
+
+    auto start = std::chrono::steady_clock::now ();
+
+    tase2->start ();
+
+    TASE2Client* client = tase2->m_client;
+
+    // the dial does not hold the lock that commands and refreshes take
+    Thread_sleep (300);
+
+    bool locked = client->m_activeConnectionMtx.try_lock ();
+
+    if (locked)
+        client->m_activeConnectionMtx.unlock ();
+
+    bool active = waitFor (
+        [client] () {
+            std::lock_guard<std::mutex> lock (client->m_activeConnectionMtx);
+            return client->m_active_connection
+                   && client->m_active_connection->Active ();
+        },
+        10000);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds> (
+                       std::chrono::steady_clock::now () - start)
+                       .count ();
+
+    if (!active)
+    {
+        close (silent);
+        destroyServer (server2);
+        FAIL () << "No active connection within timeout";
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (client->m_activeConnectionMtx);
+        ASSERT_EQ (client->m_active_connection->m_tcpPort, 10003);
+    }
+
+    // waited the grace window (1000 ms) for the first server, but neither
+    // the backup timeout (5000 ms) nor its connect timeout (10000 ms)
+    ASSERT_GE (elapsed, 900);
+    ASSERT_LT (elapsed, 4000);
+
+    ASSERT_TRUE (locked);
+
+    tase2->stop ();
+    close (silent);
+    destroyServer (server2);
+}
+
+TEST_F (ConnectionHandlingTest, FailoverOnStateChange)
+{
+    tase2->setJsonConfig (protocol_config_grace, exchanged_data, tls_config);
+
+    TestServer server1 = createServer (10002, "1.1.1.999", "1.1.1.998");
+    TestServer server2 = createServer (10003, "1.1.1.997", "1.1.1.996");
+
+    tase2->start ();
+
+    TASE2Client* client = tase2->m_client;
+
+    bool active = waitFor (
+        [client] () {
+            std::lock_guard<std::mutex> lock (client->m_activeConnectionMtx);
+            return client->m_active_connection
+                   && client->m_active_connection->m_tcpPort == 10002
+                   && client->m_active_connection->Connected ();
+        },
+        10000);
+
+    if (!active)
+    {
+        destroyServer (server1);
+        destroyServer (server2);
+        FAIL () << "No active connection within timeout";
+    }
+
+    TASE2ClientConnection* first = client->m_active_connection;
+
+    Tase2_Server_stop (server1.server);
+
+    auto start = std::chrono::steady_clock::now ();
+
+    // the endpoint state change wakes the connection thread, it does not
+    // wait for its next supervision period (1 s)
+    ASSERT_TRUE (waitFor ([first] () { return !first->Connected (); }, 5000));
+
+    auto detected = std::chrono::duration_cast<std::chrono::milliseconds> (
+                        std::chrono::steady_clock::now () - start)
+                        .count ();
+
+    // and the lost association wakes the monitoring thread
+    bool failedOver = waitFor (
+        [client] () {
+            std::lock_guard<std::mutex> lock (client->m_activeConnectionMtx);
+            return client->m_active_connection
+                   && client->m_active_connection->m_tcpPort == 10003
+                   && client->m_active_connection->Connected ();
+        },
+        10000);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds> (
+                       std::chrono::steady_clock::now () - start)
+                       .count ();
+
+    tase2->stop ();
+    destroyServer (server1);
+    destroyServer (server2);
+
+    ASSERT_LT (detected, 500);
+    ASSERT_TRUE (failedOver);
+
+    // at most the grace window (1000 ms) for the first server, far from
+    // the backup timeout (5000 ms)
+    ASSERT_LT (elapsed, 3000);
+}
+
+TEST_F (ConnectionHandlingTest, StatisticsFromIngestThread)
+{
+    tase2->setJsonConfig (protocol_config_statistics, exchanged_data,
+                          tls_config);
+
+    TestServer server = createServer (10002, "1.1.1.999", "1.1.1.998");
+
+    tase2->start ();
+
+    std::thread::id expected = tase2->m_client->m_ingestThread->get_id ();
+
+    // sent when the association is up, but not by the connection thread
+    bool received
+        = waitFor ([this] () { return ingestCallbackCalled > 0; }, 10000);
+
+    tase2->stop ();
+    destroyServer (server);
+
+    ASSERT_TRUE (received);
+    ASSERT_EQ (storedReadings[0]->getAssetName (), "tase2_statistics");
+    ASSERT_TRUE (hasObject (*storedReadings[0], "connection_statistics"));
+    ASSERT_EQ (ingestThread, expected);
+}
+
+TEST_F (ConnectionHandlingTest, HotStandbyFailover)
+{
+    tase2->setJsonConfig (protocol_config_hot, exchanged_data_1, tls_config);
+
+    TestServer server1 = createServer (10002, "1.1.1.999", "1.1.1.998", true);
+    TestServer server2 = createServer (10003, "1.1.1.997", "1.1.1.996", true);
+
+    tase2->start ();
+
+    TASE2Client* client = tase2->m_client;
+    TASE2ClientConnection* first = client->m_connections->front ();
+    TASE2ClientConnection* second = client->m_connections->back ();
+
+    // the first server is active, the second one is armed
+    bool armed = waitFor (
+        [client, first, second] () {
+            std::lock_guard<std::mutex> lock (client->m_activeConnectionMtx);
+            return client->m_active_connection == first && first->Active ()
+                   && second->Connected () && second->Armed ();
+        },
+        10000);
+
+    if (!armed)
+    {
+        destroyServer (server1);
+        destroyServer (server2);
+        FAIL () << "Hot standby not armed within timeout";
+    }
+
+    ASSERT_FALSE (second->Active ());
+
+    {
+        std::lock_guard<std::mutex> lock (second->m_dstsLock);
+        ASSERT_EQ (second->m_dstsStates.size (), 1);
+        ASSERT_NE (second->m_dstsStates[0].ts, nullptr);
+        ASSERT_FALSE (second->m_dstsStates[0].enabled);
+    }
+
+    // reports of the active connection
+    int count = ingestCallbackCalled;
+    ASSERT_TRUE (
+        waitFor ([&] () { return ingestCallbackCalled >= count + 2; }, 5000));
+
+    // the first server fails -> the armed standby only enables its DSTS
+    Tase2_Server_stop (server1.server);
+
+    auto start = std::chrono::steady_clock::now ();
+
+    bool failover = waitFor (
+        [client, second] () {
+            std::lock_guard<std::mutex> lock (client->m_activeConnectionMtx);
+            return client->m_active_connection == second
+                   && second->Active ();
+        },
+        10000);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds> (
+                       std::chrono::steady_clock::now () - start)
+                       .count ();
+
+    if (!failover)
+    {
+        destroyServer (server1);
+        destroyServer (server2);
+        FAIL () << "No failover to the hot standby within timeout";
+    }
+
+    // no new association and no dial of the redundancy group
+    ASSERT_LT (elapsed, 3000);
+    ASSERT_TRUE (second->Connected ());
+
+    ASSERT_TRUE (waitFor (
+        [second] () {
+            std::lock_guard<std::mutex> lock (second->m_dstsLock);
+            return second->m_dstsStates.size () == 1
+                   && second->m_dstsStates[0].enabled;
+        },
+        2000));
+
+    // reports of the former standby
+    count = ingestCallbackCalled;
+    ASSERT_TRUE (
+        waitFor ([&] () { return ingestCallbackCalled >= count + 2; }, 5000));
+
+    tase2->stop ();
+    destroyServer (server1);
+    destroyServer (server2);
+}
+
+TEST_F (ConnectionHandlingTest, TLSCredentialReuse)
+{
+    tase2->setJsonConfig (protocol_config_1, exchanged_data, tls_config_2);
+
+    setenv ("FLEDGE_DATA", "../tests/data", 1);
+
+    TLSConfiguration tlsConfig = TLSConfiguration_create ();
+
+    TLSConfiguration_addCACertificateFromFile (
+        tlsConfig, "../tests/data/etc/certs/tase2_ca.cer");
+    TLSConfiguration_setOwnCertificateFromFile (
+        tlsConfig, "../tests/data/etc/certs/tase2_server.cer");
+    TLSConfiguration_setOwnKeyFromFile (
+        tlsConfig, "../tests/data/etc/certs/tase2_server.key", NULL);
+    TLSConfiguration_addAllowedCertificateFromFile (
+        tlsConfig, "../tests/data/etc/certs/tase2_client.cer");
+    TLSConfiguration_setChainValidation (tlsConfig, true);
+    TLSConfiguration_setAllowOnlyKnownCertificates (tlsConfig, true);
+
+    TestServer server
+        = createServer (10002, "1.1.1.999", "1.1.1.998", false, tlsConfig);
+
+    tase2->start ();
+
+    TASE2Client* client = tase2->m_client;
+    TASE2ClientConnection* connection = client->m_connections->front ();
+
+    if (!waitFor ([connection] () { return connection->Connected (); },
+                  10000))
+    {
+        destroyServer (server);
+        TLSConfiguration_destroy (tlsConfig);
+        FAIL () << "Connection not established within timeout";
+    }
+
+    // the endpoint uses the credentials loaded by the client
+    std::shared_ptr<TLSContext> context = client->tlsContext ();
+
+    ASSERT_NE (context, nullptr);
+
+    {
+        std::lock_guard<std::mutex> lock (connection->m_conLock);
+        ASSERT_EQ (connection->m_tlsContext, context);
+    }
+
+    Tase2_Server_stop (server.server);
+
+    ASSERT_TRUE (waitFor ([connection] () { return !connection->Connected (); },
+                          5000));
+
+    Tase2_Server_start (server.server);
+
+    if (!waitFor (
+            [connection] () {
+                return connection->Connected () && connection->m_reconnects > 0;
+            },
+            20000))
+    {
+        destroyServer (server);
+        TLSConfiguration_destroy (tlsConfig);
+        FAIL () << "Connection not established again within timeout";
+    }
+
+    // the files did not change, the reconnect did not load them again
+    ASSERT_EQ (client->tlsContext (), context);
+
+    {
+        std::lock_guard<std::mutex> lock (connection->m_conLock);
+        ASSERT_EQ (connection->m_tlsContext, context);
+    }
+
+    tase2->stop ();
+    destroyServer (server);
+    TLSConfiguration_destroy (tlsConfig);
+}
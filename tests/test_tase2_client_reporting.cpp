@@ -6,6 +6,7 @@
 #include <tase2.hpp>
 
 #include <boost/thread.hpp>
+#include <functional>
 #include <libtase2/hal_thread.h>
 #include <utility>
 #include <vector>
@@ -101,6 +102,49 @@ static const string protocol_config_1 = QUOTE ({
     }
 });
 
+static const string protocol_config_fallback = QUOTE ({
+    "protocol_stack" : {
+        "name" : "tase2client",
+        "version" : "0.0.1",
+        "transport_layer" : {
+            "connections" : [ {
+                "ip_addr" : "127.0.0.1",
+                "port" : 10002,
+                "osi" : {
+                    "local_ap_title" : "1.1.1.998",
+                    "local_ae_qualifier" : 12,
+                    "remote_ap_title" : "1.1.1.999",
+                    "remote_ae_qualifier" : 12
+                },
+                "tls" : false
+            } ]
+        },
+        "application_layer" : {
+            "polling_interval" : 0,
+            "fallback_polling_interval" : 200,
+            "datasets" : [ {
+                "domain" : "icc1",
+                "dataset_ref" : "DataSet1",
+                "entries" : [ "icc1/datapointReal", "icc1/datapointState" ],
+                "dynamic" : false
+            } ],
+            "dataset_transfer_sets" : [ {
+                "domain" : "icc1",
+                "name" : "dsts1",
+                "dataset_ref" : "DataSet1",
+                "dsConditions" : [ "interval" ],
+                "startTime" : 0,
+                "interval" : 1,
+                "bufTm" : 0,
+                "integrityCheck" : 2,
+                "critical" : false,
+                "rbe" : false,
+                "allChangesReported" : true
+            } ]
+        }
+    }
+});
+
 static const string exchanged_data = QUOTE ({
     "exchanged_data" : {
         "datapoints" : [
@@ -260,11 +304,198 @@ static const string tls_config = QUOTE ({
     }
 });
 
+/* the server of the reporting tests, 16 indication points of all types and
+ * the DSTS dsts1. With staticDataSet the points are in the dataset DataSet1,
+ * otherwise the client creates the dataset. */
+struct TestServer
+{
+    Tase2_DataModel model = nullptr;
+    Tase2_Endpoint endpoint = nullptr;
+    Tase2_Server server = nullptr;
+};
+
+static TestServer
+createServer (bool staticDataSet)
+{
+    Tase2_DataModel model = Tase2_DataModel_create ();
+
+    Tase2_Domain icc = Tase2_DataModel_addDomain (model, "icc1");
+
+    Tase2_BilateralTable blt
+        = Tase2_BilateralTable_create ("blt1", icc, "1.1.1.998", 12);
+
+    Tase2_Endpoint endpoint = Tase2_Endpoint_create (nullptr, true);
+
+    Tase2_Endpoint_setLocalIpAddress (endpoint, "0.0.0.0");
+    Tase2_Endpoint_setLocalTcpPort (endpoint, 10002);
+
+    Tase2_Endpoint_setLocalApTitle (endpoint, "1.1.1.999", 12);
+
+    Tase2_IndicationPoint datapointReal = Tase2_Domain_addIndicationPoint (
+        icc, "datapointReal", TASE2_IND_POINT_TYPE_REAL, TASE2_NO_QUALITY,
+        TASE2_NO_TIMESTAMP, false, true);
+
+    Tase2_IndicationPoint datapointRealQ = Tase2_Domain_addIndicationPoint (
+        icc, "datapointRealQ", TASE2_IND_POINT_TYPE_REAL, TASE2_QUALITY,
+        TASE2_NO_TIMESTAMP, false, true);
+
+    Tase2_IndicationPoint datapointRealQTime
+        = Tase2_Domain_addIndicationPoint (
+            icc, "datapointRealQTime", TASE2_IND_POINT_TYPE_REAL,
+            TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
+
+    Tase2_IndicationPoint datapointRealQTimeExt
+        = Tase2_Domain_addIndicationPoint (
+            icc, "datapointRealQTimeExt", TASE2_IND_POINT_TYPE_REAL,
+            TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
+
+    Tase2_IndicationPoint datapointState = Tase2_Domain_addIndicationPoint (
+        icc, "datapointState", TASE2_IND_POINT_TYPE_STATE, TASE2_NO_QUALITY,
+        TASE2_NO_TIMESTAMP, false, true);
+
+    Tase2_IndicationPoint datapointStateQ = Tase2_Domain_addIndicationPoint (
+        icc, "datapointStateQ", TASE2_IND_POINT_TYPE_STATE, TASE2_QUALITY,
+        TASE2_NO_TIMESTAMP, false, true);
+
+    Tase2_IndicationPoint datapointStateQTime
+        = Tase2_Domain_addIndicationPoint (
+            icc, "datapointStateQTime", TASE2_IND_POINT_TYPE_STATE,
+            TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
+
+    Tase2_IndicationPoint datapointStateQTimeExt
+        = Tase2_Domain_addIndicationPoint (
+            icc, "datapointStateQTimeExt", TASE2_IND_POINT_TYPE_STATE,
+            TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
+
+    Tase2_IndicationPoint datapointDiscrete = Tase2_Domain_addIndicationPoint (
+        icc, "datapointDiscrete", TASE2_IND_POINT_TYPE_DISCRETE,
+        TASE2_NO_QUALITY, TASE2_NO_TIMESTAMP, false, true);
+
+    Tase2_IndicationPoint datapointDiscreteQ
+        = Tase2_Domain_addIndicationPoint (
+            icc, "datapointDiscreteQ", TASE2_IND_POINT_TYPE_DISCRETE,
+            TASE2_QUALITY, TASE2_NO_TIMESTAMP, false, true);
+
+    Tase2_IndicationPoint datapointDiscreteQTime
+        = Tase2_Domain_addIndicationPoint (
+            icc, "datapointDiscreteQTime", TASE2_IND_POINT_TYPE_DISCRETE,
+            TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
+
+    Tase2_IndicationPoint datapointDiscreteQTimeExt
+        = Tase2_Domain_addIndicationPoint (
+            icc, "datapointDiscreteQTimeExt", TASE2_IND_POINT_TYPE_DISCRETE,
+            TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
+
+    Tase2_IndicationPoint datapointStateSup = Tase2_Domain_addIndicationPoint (
+        icc, "datapointStateSup", TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL,
+        TASE2_NO_QUALITY, TASE2_NO_TIMESTAMP, false, true);
+
+    Tase2_IndicationPoint datapointStateSupQ
+        = Tase2_Domain_addIndicationPoint (
+            icc, "datapointStateSupQ", TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL,
+            TASE2_QUALITY, TASE2_NO_TIMESTAMP, false, true);
+
+    Tase2_IndicationPoint datapointStateSupQTime
+        = Tase2_Domain_addIndicationPoint (
+            icc, "datapointStateSupQTime",
+            TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL, TASE2_QUALITY,
+            TASE2_TIMESTAMP, false, true);
+
+    Tase2_IndicationPoint datapointStateSupQTimeExt
+        = Tase2_Domain_addIndicationPoint (
+            icc, "datapointStateSupQTimeExt",
+            TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL, TASE2_QUALITY,
+            TASE2_TIMESTAMP_EXTENDED, false, true);
+
+    Tase2_Domain_addDSTransferSet (icc, "dsts1");
+
+    if (staticDataSet)
+    {
+        Tase2_DataSet dataSet = Tase2_Domain_addDataSet (icc, "DataSet1");
+
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointReal");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointRealQ");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointRealQTime");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointRealQTimeExt");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointState");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointStateQ");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointStateQTime");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointStateQTimeExt");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointDiscrete");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointDiscreteQ");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointDiscreteQTime");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointDiscreteQTimeExt");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointStateSup");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointStateSupQ");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointStateSupQTime");
+        Tase2_DataSet_addEntry (dataSet, icc, "datapointStateSupQTimeExt");
+    }
+
+    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointReal,
+                                       true, false);
+    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointRealQ,
+                                       true, false);
+    Tase2_BilateralTable_addDataPoint (
+        blt, (Tase2_DataPoint)datapointRealQTime, true, false);
+    Tase2_BilateralTable_addDataPoint (
+        blt, (Tase2_DataPoint)datapointRealQTimeExt, true, false);
+
+    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointState,
+                                       true, false);
+    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointStateQ,
+                                       true, false);
+    Tase2_BilateralTable_addDataPoint (
+        blt, (Tase2_DataPoint)datapointStateQTime, true, false);
+    Tase2_BilateralTable_addDataPoint (
+        blt, (Tase2_DataPoint)datapointStateQTimeExt, true, false);
+
+    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointDiscrete,
+                                       true, false);
+    Tase2_BilateralTable_addDataPoint (
+        blt, (Tase2_DataPoint)datapointDiscreteQ, true, false);
+    Tase2_BilateralTable_addDataPoint (
+        blt, (Tase2_DataPoint)datapointDiscreteQTime, true, false);
+    Tase2_BilateralTable_addDataPoint (
+        blt, (Tase2_DataPoint)datapointDiscreteQTimeExt, true, false);
+
+    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointStateSup,
+                                       true, false);
+    Tase2_BilateralTable_addDataPoint (
+        blt, (Tase2_DataPoint)datapointStateSupQ, true, false);
+    Tase2_BilateralTable_addDataPoint (
+        blt, (Tase2_DataPoint)datapointStateSupQTime, true, false);
+    Tase2_BilateralTable_addDataPoint (
+        blt, (Tase2_DataPoint)datapointStateSupQTimeExt, true, false);
+
+    Tase2_Server server = Tase2_Server_createEx (model, endpoint);
+
+    Tase2_Server_addBilateralTable (server, blt);
+
+    Tase2_Server_start (server);
+
+    TestServer test;
+    test.model = model;
+    test.endpoint = endpoint;
+    test.server = server;
+
+    return test;
+}
+
+static void
+destroyServer (TestServer& test)
+{
+    Tase2_Endpoint_destroy (test.endpoint);
+    Tase2_Server_stop (test.server);
+    Tase2_Server_destroy (test.server);
+    Tase2_DataModel_destroy (test.model);
+}
+
 class ReportingTest : public testing::Test
 {
   protected:
     TASE2* tase2 = nullptr;
     int ingestCallbackCalled = 0;
+    int ingestBatchCallbackCalled = 0;
     Reading* storedReading = nullptr;
     int clockSyncHandlerCalled = 0;
     std::vector<Reading*> storedReadings;
@@ -371,20 +602,24 @@ class ReportingTest : public testing::Test
     }
 
     static void
-    ingestCallback (void* parameter, Reading reading)
+    ingestCallbackV2 (void* parameter, std::vector<Reading*>* readings)
     {
         auto self = (ReportingTest*)parameter;
 
-        printf ("ingestCallback called -> asset: (%s)\n",
-                reading.getAssetName ().c_str ());
-
-        std::vector<Datapoint*> dataPoints = reading.getReadingData ();
-
-        for (Datapoint* sdp : dataPoints)
+        for (Reading* reading : *readings)
         {
-            printf ("name: %s value: %s\n", sdp->getName ().c_str (),
-                    sdp->getData ().toString ().c_str ());
+            self->storedReadings.push_back (reading);
         }
+        delete readings;
+
+        self->ingestBatchCallbackCalled++;
+    }
+
+    static void
+    ingestCallback (void* parameter, Reading reading)
+    {
+        auto self = (ReportingTest*)parameter;
+
         self->storedReading = new Reading (reading);
 
         self->storedReadings.push_back (self->storedReading);
@@ -461,158 +696,83 @@ TEST_F (ReportingTest, ReportingAllType)
 {
     tase2->setJsonConfig (protocol_config, exchanged_data, tls_config);
 
-    Tase2_DataModel model = Tase2_DataModel_create ();
-
-    Tase2_Domain icc = Tase2_DataModel_addDomain (model, "icc1");
-
-    Tase2_BilateralTable blt
-        = Tase2_BilateralTable_create ("blt1", icc, "1.1.1.998", 12);
-
-    Tase2_Endpoint endpoint = Tase2_Endpoint_create (nullptr, true);
-
-    Tase2_Endpoint_setLocalIpAddress (endpoint, "0.0.0.0");
-    Tase2_Endpoint_setLocalTcpPort (endpoint, 10002);
-
-    Tase2_Endpoint_setLocalApTitle (endpoint, "1.1.1.999", 12);
-
-    Tase2_IndicationPoint datapointReal = Tase2_Domain_addIndicationPoint (
-        icc, "datapointReal", TASE2_IND_POINT_TYPE_REAL, TASE2_NO_QUALITY,
-        TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointRealQ = Tase2_Domain_addIndicationPoint (
-        icc, "datapointRealQ", TASE2_IND_POINT_TYPE_REAL, TASE2_QUALITY,
-        TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointRealQTime
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointRealQTime", TASE2_IND_POINT_TYPE_REAL,
-            TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointRealQTimeExt
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointRealQTimeExt", TASE2_IND_POINT_TYPE_REAL,
-            TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
-
-    Tase2_IndicationPoint datapointState = Tase2_Domain_addIndicationPoint (
-        icc, "datapointState", TASE2_IND_POINT_TYPE_STATE, TASE2_NO_QUALITY,
-        TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointStateQ = Tase2_Domain_addIndicationPoint (
-        icc, "datapointStateQ", TASE2_IND_POINT_TYPE_STATE, TASE2_QUALITY,
-        TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointStateQTime
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateQTime", TASE2_IND_POINT_TYPE_STATE,
-            TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
+    TestServer server = createServer (true);
+    tase2->start ();
 
-    Tase2_IndicationPoint datapointStateQTimeExt
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateQTimeExt", TASE2_IND_POINT_TYPE_STATE,
-            TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
+    ASSERT_TRUE (tase2->m_config->m_protocolConfigComplete);
 
-    Tase2_IndicationPoint datapointDiscrete = Tase2_Domain_addIndicationPoint (
-        icc, "datapointDiscrete", TASE2_IND_POINT_TYPE_DISCRETE,
-        TASE2_NO_QUALITY, TASE2_NO_TIMESTAMP, false, true);
+    Thread_sleep (500);
 
-    Tase2_IndicationPoint datapointDiscreteQ
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointDiscreteQ", TASE2_IND_POINT_TYPE_DISCRETE,
-            TASE2_QUALITY, TASE2_NO_TIMESTAMP, false, true);
+    TASE2Client* client = tase2->m_client;
+    TASE2ClientConnection* connection = client->m_active_connection;
+    Tase2_Endpoint clientEndpoint = connection->m_endpoint;
 
-    Tase2_IndicationPoint datapointDiscreteQTime
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointDiscreteQTime", TASE2_IND_POINT_TYPE_DISCRETE,
-            TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
+    ASSERT_TRUE (Tase2_Endpoint_getState (clientEndpoint)
+                 == TASE2_ENDPOINT_STATE_CONNECTED);
 
-    Tase2_IndicationPoint datapointDiscreteQTimeExt
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointDiscreteQTimeExt", TASE2_IND_POINT_TYPE_DISCRETE,
-            TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
+    Thread_sleep (1000);
 
-    Tase2_IndicationPoint datapointStateSup = Tase2_Domain_addIndicationPoint (
-        icc, "datapointStateSup", TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL,
-        TASE2_NO_QUALITY, TASE2_NO_TIMESTAMP, false, true);
+    auto timeout = std::chrono::seconds (3);
+    auto start = std::chrono::high_resolution_clock::now ();
+    while (ingestCallbackCalled < 16)
+    {
+        auto now = std::chrono::high_resolution_clock::now ();
+        if (now - start > timeout)
+        {
+            destroyServer (server);
+            FAIL () << "Callback not called within timeout";
+        }
+        Thread_sleep (10);
+    }
 
-    Tase2_IndicationPoint datapointStateSupQ
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateSupQ", TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL,
-            TASE2_QUALITY, TASE2_NO_TIMESTAMP, false, true);
+    tase2->stop ();
+    destroyServer (server);
+}
 
-    Tase2_IndicationPoint datapointStateSupQTime
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateSupQTime",
-            TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL, TASE2_QUALITY,
-            TASE2_TIMESTAMP, false, true);
+TEST_F (ReportingTest, ReportingAllTypeDynamicDataset)
+{
+    tase2->setJsonConfig (protocol_config_1, exchanged_data, tls_config);
 
-    Tase2_IndicationPoint datapointStateSupQTimeExt
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateSupQTimeExt",
-            TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL, TASE2_QUALITY,
-            TASE2_TIMESTAMP_EXTENDED, false, true);
+    TestServer server = createServer (false);
+    tase2->start ();
 
-    Tase2_Domain_addDSTransferSet (icc, "dsts1");
+    ASSERT_TRUE (tase2->m_config->m_protocolConfigComplete);
 
-    Tase2_DataSet dataSet = Tase2_Domain_addDataSet (icc, "DataSet1");
+    Thread_sleep (500);
 
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointReal");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointRealQ");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointRealQTime");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointRealQTimeExt");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointState");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointStateQ");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointStateQTime");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointStateQTimeExt");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointDiscrete");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointDiscreteQ");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointDiscreteQTime");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointDiscreteQTimeExt");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointStateSup");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointStateSupQ");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointStateSupQTime");
-    Tase2_DataSet_addEntry (dataSet, icc, "datapointStateSupQTimeExt");
+    TASE2Client* client = tase2->m_client;
+    TASE2ClientConnection* connection = client->m_active_connection;
+    Tase2_Endpoint clientEndpoint = connection->m_endpoint;
 
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointReal,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointRealQ,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointRealQTime, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointRealQTimeExt, true, false);
+    ASSERT_TRUE (Tase2_Endpoint_getState (clientEndpoint)
+                 == TASE2_ENDPOINT_STATE_CONNECTED);
 
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointState,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointStateQ,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateQTime, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateQTimeExt, true, false);
+    Thread_sleep (1000);
 
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointDiscrete,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointDiscreteQ, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointDiscreteQTime, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointDiscreteQTimeExt, true, false);
+    auto timeout = std::chrono::seconds (3);
+    auto start = std::chrono::high_resolution_clock::now ();
+    while (ingestCallbackCalled < 16)
+    {
+        auto now = std::chrono::high_resolution_clock::now ();
+        if (now - start > timeout)
+        {
+            destroyServer (server);
+            FAIL () << "Callback not called within timeout";
+        }
+        Thread_sleep (10);
+    }
 
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointStateSup,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateSupQ, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateSupQTime, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateSupQTimeExt, true, false);
+    tase2->stop ();
+    destroyServer (server);
+}
 
-    Tase2_Server server = Tase2_Server_createEx (model, endpoint);
+TEST_F (ReportingTest, ReportingBatchedIngest)
+{
+    tase2->registerIngestV2 (this, ingestCallbackV2);
 
-    Tase2_Server_addBilateralTable (server, blt);
+    tase2->setJsonConfig (protocol_config, exchanged_data, tls_config);
 
-    Tase2_Server_start (server);
+    TestServer server = createServer (true);
     tase2->start ();
 
     ASSERT_TRUE (tase2->m_config->m_protocolConfigComplete);
@@ -630,30 +790,28 @@ TEST_F (ReportingTest, ReportingAllType)
 
     auto timeout = std::chrono::seconds (3);
     auto start = std::chrono::high_resolution_clock::now ();
-    while (ingestCallbackCalled < 16)
+    while (ingestBatchCallbackCalled < 1)
     {
         auto now = std::chrono::high_resolution_clock::now ();
         if (now - start > timeout)
         {
-            Tase2_Endpoint_destroy (endpoint);
-            Tase2_Server_stop (server);
-            Tase2_Server_destroy (server);
-            Tase2_DataModel_destroy (model);
+            destroyServer (server);
             FAIL () << "Callback not called within timeout";
         }
         Thread_sleep (10);
     }
 
+    ASSERT_EQ (ingestCallbackCalled, 0);
+    ASSERT_EQ (storedReadings.size (), 16);
+
     tase2->stop ();
-    Tase2_Endpoint_destroy (endpoint);
-    Tase2_Server_stop (server);
-    Tase2_Server_destroy (server);
-    Tase2_DataModel_destroy (model);
+    destroyServer (server);
 }
 
-TEST_F (ReportingTest, ReportingAllTypeDynamicDataset)
+TEST_F (ReportingTest, DstsFallbackPolling)
 {
-    tase2->setJsonConfig (protocol_config_1, exchanged_data, tls_config);
+    tase2->setJsonConfig (protocol_config_fallback, exchanged_data,
+                          tls_config);
 
     Tase2_DataModel model = Tase2_DataModel_create ();
 
@@ -673,115 +831,21 @@ TEST_F (ReportingTest, ReportingAllTypeDynamicDataset)
         icc, "datapointReal", TASE2_IND_POINT_TYPE_REAL, TASE2_NO_QUALITY,
         TASE2_NO_TIMESTAMP, false, true);
 
-    Tase2_IndicationPoint datapointRealQ = Tase2_Domain_addIndicationPoint (
-        icc, "datapointRealQ", TASE2_IND_POINT_TYPE_REAL, TASE2_QUALITY,
-        TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointRealQTime
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointRealQTime", TASE2_IND_POINT_TYPE_REAL,
-            TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointRealQTimeExt
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointRealQTimeExt", TASE2_IND_POINT_TYPE_REAL,
-            TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
-
     Tase2_IndicationPoint datapointState = Tase2_Domain_addIndicationPoint (
         icc, "datapointState", TASE2_IND_POINT_TYPE_STATE, TASE2_NO_QUALITY,
         TASE2_NO_TIMESTAMP, false, true);
 
-    Tase2_IndicationPoint datapointStateQ = Tase2_Domain_addIndicationPoint (
-        icc, "datapointStateQ", TASE2_IND_POINT_TYPE_STATE, TASE2_QUALITY,
-        TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointStateQTime
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateQTime", TASE2_IND_POINT_TYPE_STATE,
-            TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointStateQTimeExt
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateQTimeExt", TASE2_IND_POINT_TYPE_STATE,
-            TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
-
-    Tase2_IndicationPoint datapointDiscrete = Tase2_Domain_addIndicationPoint (
-        icc, "datapointDiscrete", TASE2_IND_POINT_TYPE_DISCRETE,
-        TASE2_NO_QUALITY, TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointDiscreteQ
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointDiscreteQ", TASE2_IND_POINT_TYPE_DISCRETE,
-            TASE2_QUALITY, TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointDiscreteQTime
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointDiscreteQTime", TASE2_IND_POINT_TYPE_DISCRETE,
-            TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointDiscreteQTimeExt
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointDiscreteQTimeExt", TASE2_IND_POINT_TYPE_DISCRETE,
-            TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
-
-    Tase2_IndicationPoint datapointStateSup = Tase2_Domain_addIndicationPoint (
-        icc, "datapointStateSup", TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL,
-        TASE2_NO_QUALITY, TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointStateSupQ
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateSupQ", TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL,
-            TASE2_QUALITY, TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointStateSupQTime
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateSupQTime",
-            TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL, TASE2_QUALITY,
-            TASE2_TIMESTAMP, false, true);
+    Tase2_Domain_addDSTransferSet (icc, "dsts1");
 
-    Tase2_IndicationPoint datapointStateSupQTimeExt
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateSupQTimeExt",
-            TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL, TASE2_QUALITY,
-            TASE2_TIMESTAMP_EXTENDED, false, true);
+    Tase2_DataSet dataSet = Tase2_Domain_addDataSet (icc, "DataSet1");
 
-    Tase2_Domain_addDSTransferSet (icc, "dsts1");
+    Tase2_DataSet_addEntry (dataSet, icc, "datapointReal");
+    Tase2_DataSet_addEntry (dataSet, icc, "datapointState");
 
     Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointReal,
                                        true, false);
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointRealQ,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointRealQTime, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointRealQTimeExt, true, false);
-
     Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointState,
                                        true, false);
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointStateQ,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateQTime, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateQTimeExt, true, false);
-
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointDiscrete,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointDiscreteQ, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointDiscreteQTime, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointDiscreteQTimeExt, true, false);
-
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointStateSup,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateSupQ, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateSupQTime, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateSupQTimeExt, true, false);
 
     Tase2_Server server = Tase2_Server_createEx (model, endpoint);
 
@@ -796,28 +860,74 @@ TEST_F (ReportingTest, ReportingAllTypeDynamicDataset)
 
     TASE2Client* client = tase2->m_client;
     TASE2ClientConnection* connection = client->m_active_connection;
-    Tase2_Endpoint clientEndpoint = connection->m_endpoint;
 
-    ASSERT_TRUE (Tase2_Endpoint_getState (clientEndpoint)
+    ASSERT_TRUE (Tase2_Endpoint_getState (connection->m_endpoint)
                  == TASE2_ENDPOINT_STATE_CONNECTED);
 
-    Thread_sleep (1000);
-
-    auto timeout = std::chrono::seconds (3);
-    auto start = std::chrono::high_resolution_clock::now ();
-    while (ingestCallbackCalled < 16)
+    Tase2_ClientDSTransferSet ts = nullptr;
     {
-        auto now = std::chrono::high_resolution_clock::now ();
-        if (now - start > timeout)
+        std::lock_guard<std::mutex> lock (connection->m_dstsLock);
+        ASSERT_EQ (connection->m_dstsStates.size (), 1);
+        ts = connection->m_dstsStates[0].ts;
+    }
+    ASSERT_NE (ts, nullptr);
+
+    // the server got the configured integrity check, not the RBE flag
+    Tase2_ClientDSTransferSet_readValues (ts, connection->m_tase2client);
+    ASSERT_EQ (Tase2_ClientDSTransferSet_getIntegrityCheck (ts), 2);
+
+    auto fallback = [connection] () {
+        std::lock_guard<std::mutex> lock (connection->m_dstsLock);
+        return connection->m_dstsStates[0].fallback;
+    };
+
+    auto waitFor = [] (std::function<bool ()> condition, int ms) {
+        for (int waited = 0; !condition (); waited += 10)
         {
-            Tase2_Endpoint_destroy (endpoint);
-            Tase2_Server_stop (server);
-            Tase2_Server_destroy (server);
-            Tase2_DataModel_destroy (model);
-            FAIL () << "Callback not called within timeout";
+            if (waited >= ms)
+                return false;
+            Thread_sleep (10);
         }
-        Thread_sleep (10);
-    }
+        return true;
+    };
+
+    auto pollingFallback = [connection] () {
+        std::lock_guard<std::mutex> lock (connection->m_pollLock);
+        bool active = false;
+        for (const auto& unit : connection->m_pollUnits)
+        {
+            if (unit.fallback && unit.active)
+                active = true;
+        }
+        return active;
+    };
+
+    // reports every second, nothing polled
+    ASSERT_TRUE (waitFor ([this] () { return ingestCallbackCalled >= 2; },
+                          3000));
+    ASSERT_FALSE (fallback ());
+    ASSERT_FALSE (pollingFallback ());
+
+    // the server stops reporting -> the points of the DSTS are polled after
+    // three missed periods (max of interval and integrity check)
+    Tase2_ClientDSTransferSet_setStatus (ts, false);
+    ASSERT_TRUE (
+        Tase2_ClientDSTransferSet_writeValues (ts, connection->m_tase2client));
+
+    ASSERT_TRUE (waitFor (fallback, 10000));
+    ASSERT_TRUE (waitFor (pollingFallback, 1000));
+
+    int polled = ingestCallbackCalled;
+    Thread_sleep (1000);
+    ASSERT_GE (ingestCallbackCalled - polled, 4);
+
+    // reports again -> polling stops
+    Tase2_ClientDSTransferSet_setStatus (ts, true);
+    ASSERT_TRUE (
+        Tase2_ClientDSTransferSet_writeValues (ts, connection->m_tase2client));
+
+    ASSERT_TRUE (waitFor ([&] () { return !fallback (); }, 3000));
+    ASSERT_TRUE (waitFor ([&] () { return !pollingFallback (); }, 1000));
 
     tase2->stop ();
     Tase2_Endpoint_destroy (endpoint);
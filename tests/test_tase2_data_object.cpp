@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+#include <plugin_api.h>
+#include <tase2.hpp>
+
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+/*
+ * Allocation counting for the data_object test. Only allocations
+ * of the thread that enabled counting are taken into account.
+ */
+static thread_local bool countAllocations = false;
+static thread_local uint64_t allocationCount = 0;
+
+void*
+operator new (size_t size)
+{
+    if (countAllocations)
+        allocationCount++;
+
+    void* ptr = malloc (size == 0 ? 1 : size);
+
+    if (ptr == nullptr)
+        throw std::bad_alloc ();
+
+    return ptr;
+}
+
+void
+operator delete (void* ptr) noexcept
+{
+    free (ptr);
+}
+
+void
+operator delete (void* ptr, size_t) noexcept
+{
+    free (ptr);
+}
+
+static const string exchanged_data = QUOTE ({
+    "exchanged_data" : {
+        "datapoints" : [ {
+            "pivot_id" : "TS6",
+            "label" : "TS6",
+            "protocols" : [ {
+                "name" : "tase2",
+                "ref" : "icc1:datapointRealQTimeExt",
+                "typeid" : "RealQTimeExt"
+            } ]
+        } ]
+    }
+});
+
+static const string exchanged_data_duplicate = QUOTE ({
+    "exchanged_data" : {
+        "datapoints" : [
+            {
+                "pivot_id" : "TS1",
+                "label" : "TS1",
+                "protocols" : [ {
+                    "name" : "tase2",
+                    "ref" : "icc1:datapointReal",
+                    "typeid" : "Real"
+                } ]
+            },
+            {
+                "pivot_id" : "TS2",
+                "label" : "TS2",
+                "protocols" : [ {
+                    "name" : "tase2",
+                    "ref" : "icc1:datapointState",
+                    "typeid" : "State"
+                } ]
+            },
+            {
+                "pivot_id" : "TS3",
+                "label" : "TS3",
+                "protocols" : [ {
+                    "name" : "tase2",
+                    "ref" : "icc1:datapointReal",
+                    "typeid" : "RealQ"
+                } ]
+            }
+        ]
+    }
+});
+
+template <class F>
+static uint64_t
+countAllocationsOf (F func)
+{
+    allocationCount = 0;
+    countAllocations = true;
+    func ();
+    countAllocations = false;
+    return allocationCount;
+}
+
+template <class T>
+static void
+addDatapoint (std::vector<Datapoint*>* datapoints, const std::string& name,
+              const T& value)
+{
+    DatapointValue dpv (value);
+    datapoints->push_back (new Datapoint (name, dpv));
+}
+
+TEST (DataObjectTest, AllocationsPerValue)
+{
+    TASE2ClientConfig config;
+    config.importExchangeConfig (exchanged_data);
+
+    auto def = config.getExchangeDefinitionByRef ("icc1:datapointRealQTimeExt");
+    ASSERT_NE (def, nullptr);
+    ASSERT_EQ (def->domain, "icc1");
+    ASSERT_EQ (def->name, "datapointRealQTimeExt");
+    ASSERT_EQ (def->typeName, "RealQTimeExt");
+
+    TASE2Client client (nullptr, &config);
+
+    PointUpdate update;
+    update.def = def;
+    update.realValue = 42.5;
+    update.flags = TASE2_DATA_FLAGS_VALIDITY_VALID;
+    update.timestamp = 1700000000000;
+
+    uint64_t dataObject = countAllocationsOf ([&client, &update] () {
+        Datapoint* dp = client.m_createDataObject (update);
+        delete dp;
+    });
+
+    // the same data_object built by hand from strings prepared up front: what
+    // the reading itself costs, without any per value parsing or copying of
+    // the configuration
+    std::string typeName = def->typeName;
+    std::string domain = def->domain;
+    std::string name = def->name;
+
+    uint64_t tree = countAllocationsOf ([&] () {
+        auto datapoints = new std::vector<Datapoint*>;
+        datapoints->reserve (9);
+
+        addDatapoint (datapoints, "do_type", typeName);
+        addDatapoint (datapoints, "do_domain", domain);
+        addDatapoint (datapoints, "do_name", name);
+        addDatapoint (datapoints, "do_value", 42.5);
+        addDatapoint (datapoints, "do_validity", std::string ("valid"));
+        addDatapoint (datapoints, "do_cs", std::string ("telemetered"));
+        addDatapoint (datapoints, "do_quality_normal_value",
+                      std::string ("normal"));
+        addDatapoint (datapoints, "do_ts", (long)1700000000000);
+        addDatapoint (datapoints, "do_ts_validity", std::string ("valid"));
+
+        DatapointValue dpv (datapoints, true);
+        delete new Datapoint ("data_object", dpv);
+    });
+
+    ASSERT_GT (tree, 0);
+    ASSERT_LE (dataObject, tree);
+}
+
+TEST (DataObjectTest, ConverterPerType)
+{
+    TASE2ClientConfig config;
+    config.importExchangeConfig (exchanged_data);
+
+    auto def = config.getExchangeDefinitionByRef ("icc1:datapointRealQTimeExt");
+    ASSERT_NE (def, nullptr);
+    ASSERT_EQ (def->converter, getValueConverter (REALQTIMEEXT));
+
+    const ValueConverter* converter = getValueConverter (REALQTIMEEXT);
+    ASSERT_STREQ (converter->typeName, "RealQTimeExt");
+    ASSERT_TRUE (converter->isReal);
+    ASSERT_TRUE (converter->hasQuality);
+    ASSERT_TRUE (converter->hasTimestamp);
+
+    converter = getValueConverter (STATESUPQ);
+    ASSERT_STREQ (converter->typeName, "StateSupQ");
+    ASSERT_FALSE (converter->isReal);
+    ASSERT_TRUE (converter->hasQuality);
+    ASSERT_FALSE (converter->hasTimestamp);
+
+    converter = getValueConverter (SETPOINTREAL);
+    ASSERT_TRUE (converter->isReal);
+    ASSERT_FALSE (converter->hasQuality);
+
+    // every type name round trips through the configuration parser
+    for (int type = REAL; type <= SETPOINTDISCRETE; type++)
+    {
+        ASSERT_EQ (TASE2ClientConfig::getDpTypeFromString (
+                       getValueConverter ((DPTYPE)type)->typeName),
+                   (DPTYPE)type);
+    }
+
+    ASSERT_STREQ (getValueConverter (DP_TYPE_UNKNOWN)->typeName, "");
+}
+
+TEST (DataObjectTest, LookupWithoutAllocation)
+{
+    TASE2ClientConfig config;
+    config.importExchangeConfig (exchanged_data);
+
+    auto def = config.getExchangeDefinitionByRef ("icc1:datapointRealQTimeExt");
+    ASSERT_NE (def, nullptr);
+
+    const DataExchangeDefinition* found = nullptr;
+
+    uint64_t allocations = countAllocationsOf ([&config, &found] () {
+        found = config.findExchangeDefinition ("icc1", "datapointRealQTimeExt");
+    });
+
+    ASSERT_EQ (found, def);
+    ASSERT_EQ (allocations, 0);
+
+    ASSERT_EQ (config.findExchangeDefinition ("icc1", "unknown"), nullptr);
+    ASSERT_EQ (config.findExchangeDefinition ("icc2", "datapointRealQTimeExt"),
+               nullptr);
+
+    ASSERT_EQ (config.getExchangeDefinitionByLabel (def->label), def);
+    ASSERT_EQ (&config.getExchangeDefinition (def->id), def);
+
+    // every configured point can be found by its domain and name, ids are
+    // the positions in the definition table
+    PointId id = 0;
+
+    for (const auto& point : config.ExchangeDefinition ())
+    {
+        ASSERT_EQ (point.id, id++);
+        ASSERT_EQ (config.findExchangeDefinition (point.domain.c_str (),
+                                                  point.name.c_str ()),
+                   &point);
+    }
+}
+
+TEST (DataObjectTest, DuplicateRef)
+{
+    TASE2ClientConfig config;
+    config.importExchangeConfig (exchanged_data_duplicate);
+
+    // the last definition of the reference wins and keeps the first id
+    ASSERT_EQ (config.ExchangeDefinition ().size (), 2);
+
+    auto def = config.getExchangeDefinitionByRef ("icc1:datapointReal");
+    ASSERT_NE (def, nullptr);
+    ASSERT_EQ (def->id, 0);
+    ASSERT_EQ (def->label, "TS3");
+    ASSERT_EQ (def->typeName, "RealQ");
+
+    ASSERT_EQ (config.getExchangeDefinitionByLabel ("TS3"), def);
+    ASSERT_EQ (config.getExchangeDefinitionByLabel ("TS2")->id, 1);
+
+    // the replaced label no longer resolves to the point
+    ASSERT_EQ (config.getExchangeDefinitionByLabel ("TS1"), nullptr);
+}
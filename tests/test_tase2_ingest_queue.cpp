@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include <tase2_ingest_queue.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TEST (IngestQueueTest, FifoOrder)
+{
+    IngestQueue<int> queue (8);
+
+    ASSERT_EQ (queue.capacity (), 8);
+    ASSERT_TRUE (queue.empty ());
+
+    for (int i = 0; i < 8; i++)
+    {
+        ASSERT_TRUE (queue.tryPush (i));
+    }
+
+    ASSERT_FALSE (queue.tryPush (8));
+    ASSERT_EQ (queue.size (), 8);
+    ASSERT_EQ (queue.highWaterMark (), 8);
+
+    int value = -1;
+
+    for (int i = 0; i < 8; i++)
+    {
+        ASSERT_TRUE (queue.tryPop (value));
+        ASSERT_EQ (value, i);
+    }
+
+    ASSERT_FALSE (queue.tryPop (value));
+    ASSERT_TRUE (queue.empty ());
+}
+
+TEST (IngestQueueTest, OverflowPolicies)
+{
+    IngestQueue<int> queue (4);
+    int value = -1;
+
+    for (int i = 0; i < 4; i++)
+    {
+        queue.push (i, OverflowPolicy::DROP_NEWEST);
+    }
+
+    ASSERT_FALSE (queue.push (4, OverflowPolicy::DROP_NEWEST));
+    ASSERT_EQ (queue.dropped (), 1);
+
+    ASSERT_FALSE (queue.push (5, OverflowPolicy::DROP_OLDEST));
+    ASSERT_EQ (queue.dropped (), 2);
+    ASSERT_EQ (queue.overflows (), 2);
+
+    // 0 was dropped to make room for 5
+    ASSERT_TRUE (queue.tryPop (value));
+    ASSERT_EQ (value, 1);
+
+    ASSERT_TRUE (queue.push (6, OverflowPolicy::BLOCK));
+
+    std::vector<int> values;
+    while (queue.tryPop (value))
+    {
+        values.push_back (value);
+    }
+
+    ASSERT_EQ (values, std::vector<int> ({ 2, 3, 5, 6 }));
+}
+
+TEST (IngestQueueTest, MultipleProducers)
+{
+    IngestQueue<int> queue (1024);
+
+    const int producers = 4;
+    const int perProducer = 10000;
+
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back ([&queue, p, perProducer] () {
+            for (int i = 0; i < perProducer; i++)
+            {
+                queue.push (p * perProducer + i, OverflowPolicy::BLOCK);
+            }
+        });
+    }
+
+    std::vector<int> lastSeen (producers, -1);
+    int received = 0;
+    int value;
+
+    while (received < producers * perProducer)
+    {
+        if (queue.tryPop (value))
+        {
+            int producer = value / perProducer;
+            int seq = value % perProducer;
+
+            // items of one producer keep their order
+            ASSERT_GT (seq, lastSeen[producer]);
+            lastSeen[producer] = seq;
+            received++;
+        }
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join ();
+    }
+
+    ASSERT_EQ (queue.dropped (), 0);
+    ASSERT_TRUE (queue.empty ());
+    ASSERT_LE (queue.highWaterMark (), queue.capacity ());
+}
+
+struct QueueItem
+{
+    bool marker = false;
+    int value = 0;
+};
+
+template <> struct EvictionTraits<QueueItem>
+{
+    static bool
+    evictable (const QueueItem& item)
+    {
+        return !item.marker;
+    }
+};
+
+TEST (IngestQueueTest, DropOldestKeepsMarkers)
+{
+    IngestQueue<QueueItem> queue (4);
+
+    QueueItem begin;
+    begin.marker = true;
+    begin.value = -1;
+
+    queue.push (begin, OverflowPolicy::BLOCK);
+
+    for (int i = 0; i < 3; i++)
+    {
+        QueueItem item;
+        item.value = i;
+        queue.push (item, OverflowPolicy::DROP_OLDEST);
+    }
+
+    QueueItem end;
+    end.marker = true;
+    end.value = -2;
+
+    // ring is full: the oldest value goes, the begin marker stays first
+    ASSERT_FALSE (queue.push (end, OverflowPolicy::DROP_OLDEST));
+    ASSERT_EQ (queue.dropped (), 1);
+    ASSERT_EQ (queue.size (), 4);
+
+    // the marker moved off the ring, which has room for one more value
+    QueueItem item;
+    item.value = 3;
+    ASSERT_TRUE (queue.push (item, OverflowPolicy::DROP_OLDEST));
+
+    item.value = 4;
+    ASSERT_FALSE (queue.push (item, OverflowPolicy::DROP_OLDEST));
+    ASSERT_EQ (queue.dropped (), 2);
+
+    std::vector<int> values;
+    while (queue.tryPop (item))
+    {
+        values.push_back (item.value);
+    }
+
+    ASSERT_EQ (values, std::vector<int> ({ -1, 2, -2, 3, 4 }));
+    ASSERT_TRUE (queue.empty ());
+}
+
+TEST (IngestQueueTest, ReservedSlots)
+{
+    IngestQueue<int> queue (4, 2);
+
+    ASSERT_EQ (queue.capacity (), 6);
+
+    for (int i = 0; i < 6; i++)
+    {
+        ASSERT_TRUE (queue.tryPush (i));
+    }
+
+    // ordinary items are full, the reserve is still free
+    ASSERT_FALSE (queue.tryPush (6));
+    ASSERT_FALSE (queue.push (6, OverflowPolicy::DROP_NEWEST));
+
+    ASSERT_TRUE (queue.tryPushReserved (-1));
+    ASSERT_TRUE (queue.tryPushReserved (-2));
+    ASSERT_FALSE (queue.tryPushReserved (-3));
+
+    std::vector<int> values;
+    int value;
+
+    while (queue.tryPop (value))
+    {
+        values.push_back (value);
+    }
+
+    ASSERT_EQ (values, std::vector<int> ({ 0, 1, 2, 3, 4, 5, -1, -2 }));
+}
+
+TEST (IngestQueueTest, BlockWaitsForConsumer)
+{
+    IngestQueue<int> queue (2);
+
+    ASSERT_TRUE (queue.tryPush (0));
+    ASSERT_TRUE (queue.tryPush (1));
+
+    std::atomic<bool> pushed{ false };
+
+    std::thread producer ([&queue, &pushed] () {
+        queue.push (2, OverflowPolicy::BLOCK);
+        pushed = true;
+    });
+
+    std::this_thread::sleep_for (std::chrono::milliseconds (50));
+    ASSERT_FALSE (pushed);
+
+    int value;
+    ASSERT_TRUE (queue.tryPop (value));
+    ASSERT_EQ (value, 0);
+
+    producer.join ();
+
+    ASSERT_TRUE (pushed);
+    ASSERT_EQ (queue.dropped (), 0);
+
+    ASSERT_TRUE (queue.tryPop (value));
+    ASSERT_EQ (value, 1);
+    ASSERT_TRUE (queue.tryPop (value));
+    ASSERT_EQ (value, 2);
+}
@@ -0,0 +1,280 @@
+#include <gtest/gtest.h>
+#include <plugin_api.h>
+#include <tase2.hpp>
+
+using namespace std;
+
+static const string protocol_config = QUOTE ({
+    "protocol_stack" : {
+        "name" : "tase2client",
+        "version" : "0.0.1",
+        "transport_layer" : {
+            "connections" : [ {
+                "ip_addr" : "127.0.0.1",
+                "port" : 10002,
+                "tls" : false
+            } ]
+        },
+        "application_layer" : {
+            "polling_interval" : 0,
+            "datasets" : [ {
+                "domain" : "icc1",
+                "dataset_ref" : "DataSet1",
+                "entries" : [ "icc1/datapointState", "datapointDiscrete" ],
+                "dynamic" : true
+            } ],
+            "dataset_transfer_sets" : [ {
+                "domain" : "icc1",
+                "name" : "dsts1",
+                "dataset_ref" : "DataSet1",
+                "dsConditions" : [ "interval", "integrity" ],
+                "interval" : 5,
+                "integrityCheck" : 60,
+                "suppress_unchanged" : true,
+                "heartbeat" : 60
+            } ]
+        }
+    }
+});
+
+static const string exchanged_data = QUOTE ({
+    "exchanged_data" : {
+        "datapoints" : [
+            {
+                "pivot_id" : "TS1",
+                "label" : "TS1",
+                "protocols" : [ {
+                    "name" : "tase2",
+                    "ref" : "icc1:datapointRealQ",
+                    "typeid" : "RealQ",
+                    "suppress_unchanged" : true,
+                    "heartbeat" : 10
+                } ]
+            },
+            {
+                "pivot_id" : "TS2",
+                "label" : "TS2",
+                "protocols" : [ {
+                    "name" : "tase2",
+                    "ref" : "icc1:datapointState",
+                    "typeid" : "State"
+                } ]
+            },
+            {
+                "pivot_id" : "TS3",
+                "label" : "TS3",
+                "protocols" : [ {
+                    "name" : "tase2",
+                    "ref" : "icc1:datapointDiscrete",
+                    "typeid" : "Discrete",
+                    "suppress_unchanged" : false,
+                    "heartbeat" : 30
+                } ]
+            },
+            {
+                "pivot_id" : "TS5",
+                "label" : "TS5",
+                "protocols" : [ {
+                    "name" : "tase2",
+                    "ref" : "icc1:datapointRealQTime",
+                    "typeid" : "RealQTime",
+                    "deadband" : 0.5
+                } ]
+            },
+            {
+                "pivot_id" : "TS6",
+                "label" : "TS6",
+                "protocols" : [ {
+                    "name" : "tase2",
+                    "ref" : "icc1:datapointRealQTimeExt",
+                    "typeid" : "RealQTimeExt",
+                    "deadband" : 10,
+                    "deadband_type" : "percent"
+                } ]
+            },
+            {
+                "pivot_id" : "TS7",
+                "label" : "TS7",
+                "protocols" : [ {
+                    "name" : "tase2",
+                    "ref" : "icc1:datapointStateQ",
+                    "typeid" : "StateQ",
+                    "deadband" : 1
+                } ]
+            },
+            {
+                "pivot_id" : "TS4",
+                "label" : "TS4",
+                "protocols" : [ {
+                    "name" : "tase2",
+                    "ref" : "icc1:datapointReal",
+                    "typeid" : "Real"
+                } ]
+            }
+        ]
+    }
+});
+
+TEST (LastValueTest, SuppressUnchanged)
+{
+    TASE2ClientConfig config;
+    config.importExchangeConfig (exchanged_data);
+
+    const DataExchangeDefinition* def
+        = config.getExchangeDefinitionByLabel ("TS1");
+    ASSERT_NE (def, nullptr);
+    ASSERT_TRUE (def->suppressUnchanged);
+    ASSERT_EQ (def->heartbeat, 10000);
+
+    TASE2Client client (nullptr, &config);
+    client.m_lastValues.assign (config.ExchangeDefinition ().size (),
+                                LastValue ());
+
+    PointUpdate update;
+    update.def = def;
+    update.realValue = 1.5;
+    update.flags = TASE2_DATA_FLAGS_VALIDITY_VALID;
+    update.timestamp = 1000;
+
+    // first value is always ingested
+    ASSERT_FALSE (client.m_isFiltered (update));
+
+    update.timestamp = 2000;
+    ASSERT_TRUE (client.m_isFiltered (update));
+
+    // quality change
+    update.flags = TASE2_DATA_FLAGS_VALIDITY_SUSPECT;
+    update.timestamp = 3000;
+    ASSERT_FALSE (client.m_isFiltered (update));
+
+    // value change
+    update.realValue = 2.5;
+    update.timestamp = 4000;
+    ASSERT_FALSE (client.m_isFiltered (update));
+
+    update.timestamp = 13000;
+    ASSERT_TRUE (client.m_isFiltered (update));
+
+    // heartbeat, 10 s after the last ingested update
+    update.timestamp = 14000;
+    ASSERT_FALSE (client.m_isFiltered (update));
+
+    update.timestamp = 15000;
+    ASSERT_TRUE (client.m_isFiltered (update));
+
+    // suppression is off by default
+    PointUpdate other;
+    other.def = config.getExchangeDefinitionByLabel ("TS4");
+    other.realValue = 1.0;
+    ASSERT_FALSE (client.m_isFiltered (other));
+    ASSERT_FALSE (client.m_isFiltered (other));
+}
+
+TEST (LastValueTest, DstsOptions)
+{
+    TASE2ClientConfig config;
+    config.importExchangeConfig (exchanged_data);
+    config.importProtocolConfig (protocol_config);
+
+    const DataExchangeDefinition* state
+        = config.getExchangeDefinitionByLabel ("TS2");
+    ASSERT_TRUE (state->suppressUnchanged);
+    ASSERT_EQ (state->heartbeat, 60000);
+
+    // the options of the point take precedence
+    const DataExchangeDefinition* discrete
+        = config.getExchangeDefinitionByLabel ("TS3");
+    ASSERT_FALSE (discrete->suppressUnchanged);
+    ASSERT_EQ (discrete->heartbeat, 30000);
+
+    // not in the dataset
+    const DataExchangeDefinition* real
+        = config.getExchangeDefinitionByLabel ("TS4");
+    ASSERT_FALSE (real->suppressUnchanged);
+    ASSERT_EQ (real->heartbeat, 0);
+}
+
+TEST (LastValueTest, Deadband)
+{
+    TASE2ClientConfig config;
+    config.importExchangeConfig (exchanged_data);
+
+    const DataExchangeDefinition* absolute
+        = config.getExchangeDefinitionByLabel ("TS5");
+    ASSERT_EQ (absolute->deadband, 0.5);
+    ASSERT_FALSE (absolute->deadbandPercent);
+
+    const DataExchangeDefinition* percent
+        = config.getExchangeDefinitionByLabel ("TS6");
+    ASSERT_EQ (percent->deadband, 10);
+    ASSERT_TRUE (percent->deadbandPercent);
+
+    // not a Real type
+    ASSERT_EQ (config.getExchangeDefinitionByLabel ("TS7")->deadband, 0.0);
+
+    TASE2Client client (nullptr, &config);
+    client.m_lastValues.assign (config.ExchangeDefinition ().size (),
+                                LastValue ());
+
+    PointUpdate update;
+    update.def = absolute;
+    update.realValue = 10.0;
+
+    ASSERT_FALSE (client.m_isFiltered (update));
+
+    update.realValue = 10.3;
+    ASSERT_TRUE (client.m_isFiltered (update));
+
+    // compared to the last ingested value, not the last received one
+    update.realValue = 10.6;
+    ASSERT_FALSE (client.m_isFiltered (update));
+
+    update.realValue = 10.2;
+    ASSERT_TRUE (client.m_isFiltered (update));
+
+    // quality changes pass
+    update.flags = TASE2_DATA_FLAGS_VALIDITY_HELD;
+    ASSERT_FALSE (client.m_isFiltered (update));
+
+    update.def = percent;
+    update.realValue = 200.0;
+    ASSERT_FALSE (client.m_isFiltered (update));
+
+    update.realValue = 215.0;
+    ASSERT_TRUE (client.m_isFiltered (update));
+
+    update.realValue = 179.0;
+    ASSERT_FALSE (client.m_isFiltered (update));
+
+    ASSERT_EQ (client.deadbandFilteredUpdates (), 3);
+}
+
+TEST (LastValueTest, SourceTimestamp)
+{
+    TASE2ClientConfig config;
+    config.importExchangeConfig (exchanged_data);
+
+    TASE2Client client (nullptr, &config);
+    client.m_lastValues.assign (config.ExchangeDefinition ().size (),
+                                LastValue ());
+
+    PointUpdate update;
+    update.def = config.getExchangeDefinitionByLabel ("TS4");
+    update.realValue = 1.0;
+    update.timestamp = 2000;
+    update.sourceTimestamp = 1500;
+
+    ASSERT_FALSE (client.m_isFiltered (update));
+
+    // the time stamp of the value, not when it was received
+    const LastValue& last = client.m_lastValues[update.def->id];
+    ASSERT_EQ (last.timestamp, 1500);
+    ASSERT_EQ (last.emitted, 2000);
+
+    // the receive time for values without one
+    update.timestamp = 3000;
+    update.sourceTimestamp = 0;
+
+    ASSERT_FALSE (client.m_isFiltered (update));
+    ASSERT_EQ (last.timestamp, 3000);
+}
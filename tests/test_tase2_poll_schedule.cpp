@@ -0,0 +1,320 @@
+#include <gtest/gtest.h>
+#include <tase2_client_connection.hpp>
+
+#include <vector>
+
+using namespace std;
+
+static TASE2ClientConnection*
+createConnection (TASE2ClientConfig* config)
+{
+    return new TASE2ClientConnection (nullptr, config, "127.0.0.1", 10002,
+                                      false, nullptr);
+}
+
+TEST (PollScheduleTest, SpreadPhases)
+{
+    TASE2ClientConfig config;
+    config.m_pollSchedule = PollSchedule::SPREAD;
+
+    TASE2ClientConnection* connection = createConnection (&config);
+
+    connection->m_unitOfPoint.assign (6, -1);
+    connection->m_pollWheel.reset (0);
+
+    // four units polled every second and two every 10 s
+    for (PointId id = 0; id < 6; id++)
+    {
+        TASE2ClientConnection::PollUnit unit;
+        unit.points.push_back (id);
+        unit.interval = id < 4 ? 1000 : 10000;
+        connection->m_pollUnits.push_back (unit);
+    }
+
+    connection->m_schedulePollUnits (0);
+
+    const auto& units = connection->m_pollUnits;
+
+    ASSERT_EQ (connection->m_pollCycles.size (), 2);
+    ASSERT_EQ (connection->m_pollWheel.size (), 6);
+
+    // evenly distributed over the interval
+    for (size_t k = 0; k < 4; k++)
+    {
+        ASSERT_TRUE (units[k].scheduled);
+        ASSERT_EQ (units[k].due - units[0].due, 250 * k);
+        ASSERT_EQ (connection->m_unitOfPoint[k], (int)k);
+        ASSERT_EQ (connection->m_pollCycles[units[k].cycle].interval, 1000);
+    }
+
+    ASSERT_EQ (units[4].due, units[0].due);
+    ASSERT_EQ (units[5].due - units[4].due, 5000);
+    ASSERT_EQ (connection->m_pollCycles[units[5].cycle].interval, 10000);
+
+    delete connection;
+}
+
+TEST (PollScheduleTest, BurstPhases)
+{
+    TASE2ClientConfig config;
+    ASSERT_EQ (config.pollSchedule (), PollSchedule::BURST);
+
+    TASE2ClientConnection* connection = createConnection (&config);
+
+    connection->m_unitOfPoint.assign (4, -1);
+    connection->m_pollWheel.reset (0);
+
+    for (PointId id = 0; id < 4; id++)
+    {
+        TASE2ClientConnection::PollUnit unit;
+        unit.points.push_back (id);
+        unit.interval = 1000;
+        connection->m_pollUnits.push_back (unit);
+    }
+
+    connection->m_schedulePollUnits (0);
+
+    // all read in the first pass
+    for (const auto& unit : connection->m_pollUnits)
+    {
+        ASSERT_EQ (unit.due, connection->m_pollUnits[0].due);
+    }
+
+    delete connection;
+}
+
+TEST (PollScheduleTest, CycleStatistics)
+{
+    TASE2ClientConfig config;
+    TASE2ClientConnection* connection = createConnection (&config);
+
+    TASE2ClientConnection::PollCycleStats cycle;
+    cycle.interval = 1000;
+    cycle.effectiveInterval = 1000;
+    connection->m_pollCycles.push_back (cycle);
+
+    TASE2ClientConnection::PollUnit unit;
+    unit.points = { 0, 1, 2 };
+    unit.interval = 1000;
+
+    // two reads in the first cycle, the second one 50 ms late
+    unit.due = 0;
+    connection->m_updatePollCycle (unit, 0, 100);
+    unit.due = 450;
+    connection->m_updatePollCycle (unit, 500, 650);
+
+    const auto& stats = connection->m_pollCycles[0];
+
+    ASSERT_EQ (stats.cycles, 0);
+    ASSERT_EQ (stats.busy, 250);
+    ASSERT_EQ (stats.maxLateness, 50);
+
+    // the first read of the next cycle completes the first one
+    unit.due = 1000;
+    connection->m_updatePollCycle (unit, 1000, 1020);
+
+    ASSERT_EQ (stats.cycles, 1);
+    ASSERT_EQ (stats.duration, 250);
+    ASSERT_EQ (stats.slack, 750);
+    ASSERT_EQ (stats.points, 6);
+    ASSERT_EQ (stats.maxDuration, 250);
+    ASSERT_EQ (stats.cycleStart, 1000);
+    ASSERT_EQ (stats.busy, 20);
+    ASSERT_EQ (stats.durationPercentile (50), 250);
+
+    delete connection;
+}
+
+TEST (PollScheduleTest, OverrunSkip)
+{
+    TASE2ClientConfig config;
+    ASSERT_EQ (config.overrunPolicy (), OverrunPolicy::SKIP);
+
+    TASE2ClientConnection* connection = createConnection (&config);
+    connection->m_pollWheel.reset (0);
+
+    TASE2ClientConnection::PollCycleStats stats;
+    stats.interval = 1000;
+    stats.effectiveInterval = 1000;
+    connection->m_pollCycles.push_back (stats);
+
+    TASE2ClientConnection::PollUnit unit;
+    unit.interval = 1000;
+    unit.due = 1000;
+    connection->m_pollUnits.push_back (unit);
+
+    const auto& polled = connection->m_pollUnits[0];
+    const auto& cycle = connection->m_pollCycles[0];
+
+    // in time: one interval after it was due
+    connection->m_reschedulePollUnit (0, 1200);
+    ASSERT_EQ (polled.due, 2000);
+    ASSERT_EQ (cycle.overruns, 0);
+    ASSERT_TRUE (polled.scheduled);
+
+    // ended at 4500: the reads due at 3000 and 4000 are dropped, the phase
+    // is kept
+    connection->m_reschedulePollUnit (0, 4500);
+    ASSERT_EQ (polled.due, 5000);
+    ASSERT_EQ (cycle.overruns, 1);
+    ASSERT_EQ (cycle.effectiveInterval, 1000);
+
+    delete connection;
+}
+
+TEST (PollScheduleTest, OverrunCatchUp)
+{
+    TASE2ClientConfig config;
+    config.m_overrunPolicy = OverrunPolicy::CATCH_UP;
+
+    TASE2ClientConnection* connection = createConnection (&config);
+    connection->m_pollWheel.reset (0);
+
+    TASE2ClientConnection::PollCycleStats stats;
+    stats.interval = 1000;
+    stats.effectiveInterval = 1000;
+    connection->m_pollCycles.push_back (stats);
+
+    TASE2ClientConnection::PollUnit unit;
+    unit.interval = 1000;
+    unit.due = 1000;
+    connection->m_pollUnits.push_back (unit);
+
+    // overdue, read again with the next tick of the wheel
+    connection->m_reschedulePollUnit (0, 2500);
+    ASSERT_EQ (connection->m_pollUnits[0].due, 2000);
+    ASSERT_EQ (connection->m_pollCycles[0].overruns, 1);
+
+    std::vector<uint32_t> expired;
+    connection->m_pollWheel.advance (2510, expired);
+    ASSERT_EQ (expired, std::vector<uint32_t> ({ 0 }));
+
+    delete connection;
+}
+
+TEST (PollScheduleTest, OverrunStretch)
+{
+    TASE2ClientConfig config;
+    config.m_overrunPolicy = OverrunPolicy::STRETCH;
+
+    TASE2ClientConnection* connection = createConnection (&config);
+    connection->m_pollWheel.reset (0);
+
+    TASE2ClientConnection::PollCycleStats stats;
+    stats.interval = 1000;
+    stats.effectiveInterval = 1000;
+    connection->m_pollCycles.push_back (stats);
+
+    TASE2ClientConnection::PollUnit unit;
+    unit.points.push_back (0);
+    unit.interval = 1000;
+    unit.due = 1000;
+    connection->m_pollUnits.push_back (unit);
+
+    const auto& polled = connection->m_pollUnits[0];
+    const auto& cycle = connection->m_pollCycles[0];
+
+    // the interval grows by half and the next read is one interval after
+    // the end of this one
+    connection->m_reschedulePollUnit (0, 2500);
+    ASSERT_EQ (cycle.effectiveInterval, 1500);
+    ASSERT_EQ (polled.due, 4000);
+
+    connection->m_reschedulePollUnit (0, 6000);
+    ASSERT_EQ (cycle.effectiveInterval, 2250);
+    ASSERT_EQ (polled.due, 8250);
+    ASSERT_EQ (cycle.overruns, 2);
+
+    // never beyond 16 intervals
+    for (int i = 0; i < 20; i++)
+    {
+        connection->m_reschedulePollUnit (0, polled.due + 100000);
+    }
+    ASSERT_EQ (cycle.effectiveInterval, 16000);
+
+    // shrinks by a quarter after a cycle whose reads take less than half
+    connection->m_pollCycles[0].effectiveInterval = 2000;
+    connection->m_pollCycles[0].cycleStart = 0;
+
+    TASE2ClientConnection::PollUnit read = polled;
+    read.due = 0;
+    connection->m_updatePollCycle (read, 0, 100);
+    read.due = 2000;
+    connection->m_updatePollCycle (read, 2000, 2100);
+
+    ASSERT_EQ (cycle.effectiveInterval, 1500);
+
+    delete connection;
+}
+
+TEST (PollScheduleTest, AdaptiveBackoff)
+{
+    TASE2ClientConfig config;
+    config.m_adaptivePolling.enabled = true;
+    config.m_adaptivePolling.unchangedPolls = 3;
+    config.m_adaptivePolling.factor = 2.0;
+    config.m_adaptivePolling.maxInterval = 8000;
+
+    TASE2ClientConnection* connection = createConnection (&config);
+    connection->m_pollWheel.reset (0);
+
+    TASE2ClientConnection::PollCycleStats stats;
+    stats.interval = 1000;
+    stats.effectiveInterval = 1000;
+    connection->m_pollCycles.push_back (stats);
+
+    TASE2ClientConnection::PollUnit unit;
+    unit.interval = 1000;
+    unit.due = 0;
+    connection->m_pollUnits.push_back (unit);
+
+    TASE2ClientConnection::PollUnit& polled = connection->m_pollUnits[0];
+
+    // the first read only records the values
+    connection->m_adaptPollUnit (polled, 42);
+    ASSERT_TRUE (polled.hasFingerprint);
+    ASSERT_EQ (polled.backoffInterval, 0);
+
+    // backed off after 3 unchanged polls, and again after 3 more
+    std::vector<uint64_t> intervals;
+
+    for (int i = 0; i < 12; i++)
+    {
+        connection->m_adaptPollUnit (polled, 42);
+        intervals.push_back (polled.backoffInterval);
+    }
+
+    ASSERT_EQ (intervals,
+               std::vector<uint64_t> ({ 0, 0, 2000, 2000, 2000, 4000, 4000,
+                                        4000, 8000, 8000, 8000, 8000 }));
+
+    // a backed off unit is read one back off interval later, no overrun
+    polled.due = 10000;
+    connection->m_reschedulePollUnit (0, 10100);
+    ASSERT_EQ (polled.due, 18000);
+    ASSERT_EQ (connection->m_pollCycles[0].overruns, 0);
+
+    // a change brings it back to its own interval
+    connection->m_adaptPollUnit (polled, 43);
+    ASSERT_EQ (polled.backoffInterval, 0);
+    ASSERT_EQ (polled.unchangedPolls, 0);
+
+    connection->m_reschedulePollUnit (0, 18100);
+    ASSERT_EQ (polled.due, 19000);
+
+    // so does a failed read, and the next read starts over
+    for (int i = 0; i < 3; i++)
+    {
+        connection->m_adaptPollUnit (polled, 43);
+    }
+    ASSERT_EQ (polled.backoffInterval, 2000);
+
+    connection->m_adaptPollUnit (polled, 0); // INVALID_FINGERPRINT
+    ASSERT_EQ (polled.backoffInterval, 0);
+    ASSERT_FALSE (polled.hasFingerprint);
+
+    connection->m_adaptPollUnit (polled, 43);
+    ASSERT_EQ (polled.unchangedPolls, 0);
+
+    delete connection;
+}
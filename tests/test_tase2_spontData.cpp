@@ -33,6 +33,79 @@ static const string protocol_config = QUOTE ({
     }
 });
 
+static const string protocol_config_bulk = QUOTE ({
+    "protocol_stack" : {
+        "name" : "tase2client",
+        "version" : "0.0.1",
+        "transport_layer" : {
+            "connections" : [ {
+                "ip_addr" : "127.0.0.1",
+                "port" : 10002,
+                "osi" : {
+                    "local_ap_title" : "1.1.1.998",
+                    "local_ae_qualifier" : 12,
+                    "remote_ap_title" : "1.1.1.999",
+                    "remote_ae_qualifier" : 12
+                },
+                "tls" : false
+            } ]
+        },
+        "application_layer" : {
+            "polling_interval" : 1000,
+            "bulk_polling" : true,
+            "max_dataset_members" : 10
+        }
+    }
+});
+
+static const string protocol_config_refresh = QUOTE ({
+    "protocol_stack" : {
+        "name" : "tase2client",
+        "version" : "0.0.1",
+        "transport_layer" : {
+            "connections" : [ {
+                "ip_addr" : "127.0.0.1",
+                "port" : 10002,
+                "osi" : {
+                    "local_ap_title" : "1.1.1.998",
+                    "local_ae_qualifier" : 12,
+                    "remote_ap_title" : "1.1.1.999",
+                    "remote_ae_qualifier" : 12
+                },
+                "tls" : false
+            } ]
+        },
+        "application_layer" : {
+            "polling_interval" : 60000,
+            "refresh_ttl" : 1000
+        }
+    }
+});
+
+static const string protocol_config_window = QUOTE ({
+    "protocol_stack" : {
+        "name" : "tase2client",
+        "version" : "0.0.1",
+        "transport_layer" : {
+            "connections" : [ {
+                "ip_addr" : "127.0.0.1",
+                "port" : 10002,
+                "osi" : {
+                    "local_ap_title" : "1.1.1.998",
+                    "local_ae_qualifier" : 12,
+                    "remote_ap_title" : "1.1.1.999",
+                    "remote_ae_qualifier" : 12
+                },
+                "tls" : false
+            } ]
+        },
+        "application_layer" : {
+            "polling_interval" : 1000,
+            "max_outstanding_reads" : 4
+        }
+    }
+});
+
 static const string exchanged_data = QUOTE ({
     "exchanged_data" : {
         "datapoints" : [
@@ -201,6 +274,11 @@ class SpontDataTest : public testing::Test
     int clockSyncHandlerCalled = 0;
     std::vector<Reading*> storedReadings;
 
+    Tase2_DataModel model = nullptr;
+    Tase2_Endpoint endpoint = nullptr;
+    Tase2_Server server = nullptr;
+    Tase2_IndicationPoint datapointReal = nullptr;
+
     void
     SetUp () override
     {
@@ -387,146 +465,204 @@ class SpontDataTest : public testing::Test
         ASSERT_NE (child, nullptr)
             << "Child Datapoint '" << childName << "' is nullptr";
     }
+
+    /* server with one indication point of every type */
+    void
+    startServer ()
+    {
+        model = Tase2_DataModel_create ();
+
+        Tase2_Domain icc = Tase2_DataModel_addDomain (model, "icc1");
+
+        Tase2_BilateralTable blt
+            = Tase2_BilateralTable_create ("blt1", icc, "1.1.1.998", 12);
+
+        endpoint = Tase2_Endpoint_create (nullptr, true);
+
+        Tase2_Endpoint_setLocalIpAddress (endpoint, "0.0.0.0");
+        Tase2_Endpoint_setLocalTcpPort (endpoint, 10002);
+
+        Tase2_Endpoint_setLocalApTitle (endpoint, "1.1.1.999", 12);
+
+        datapointReal = Tase2_Domain_addIndicationPoint (
+            icc, "datapointReal", TASE2_IND_POINT_TYPE_REAL, TASE2_NO_QUALITY,
+            TASE2_NO_TIMESTAMP, false, true);
+
+        Tase2_IndicationPoint datapointRealQ = Tase2_Domain_addIndicationPoint (
+            icc, "datapointRealQ", TASE2_IND_POINT_TYPE_REAL, TASE2_QUALITY,
+            TASE2_NO_TIMESTAMP, false, true);
+
+        Tase2_IndicationPoint datapointRealQTime
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointRealQTime", TASE2_IND_POINT_TYPE_REAL,
+                TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
+
+        Tase2_IndicationPoint datapointRealQTimeExt
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointRealQTimeExt", TASE2_IND_POINT_TYPE_REAL,
+                TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
+
+        Tase2_IndicationPoint datapointState = Tase2_Domain_addIndicationPoint (
+            icc, "datapointState", TASE2_IND_POINT_TYPE_STATE, TASE2_NO_QUALITY,
+            TASE2_NO_TIMESTAMP, false, true);
+
+        Tase2_IndicationPoint datapointStateQ
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointStateQ", TASE2_IND_POINT_TYPE_STATE,
+                TASE2_QUALITY, TASE2_NO_TIMESTAMP, false, true);
+
+        Tase2_IndicationPoint datapointStateQTime
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointStateQTime", TASE2_IND_POINT_TYPE_STATE,
+                TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
+
+        Tase2_IndicationPoint datapointStateQTimeExt
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointStateQTimeExt", TASE2_IND_POINT_TYPE_STATE,
+                TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
+
+        Tase2_IndicationPoint datapointDiscrete
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointDiscrete", TASE2_IND_POINT_TYPE_DISCRETE,
+                TASE2_NO_QUALITY, TASE2_NO_TIMESTAMP, false, true);
+
+        Tase2_IndicationPoint datapointDiscreteQ
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointDiscreteQ", TASE2_IND_POINT_TYPE_DISCRETE,
+                TASE2_QUALITY, TASE2_NO_TIMESTAMP, false, true);
+
+        Tase2_IndicationPoint datapointDiscreteQTime
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointDiscreteQTime", TASE2_IND_POINT_TYPE_DISCRETE,
+                TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
+
+        Tase2_IndicationPoint datapointDiscreteQTimeExt
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointDiscreteQTimeExt", TASE2_IND_POINT_TYPE_DISCRETE,
+                TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
+
+        Tase2_IndicationPoint datapointStateSup
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointStateSup",
+                TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL, TASE2_NO_QUALITY,
+                TASE2_NO_TIMESTAMP, false, true);
+
+        Tase2_IndicationPoint datapointStateSupQ
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointStateSupQ",
+                TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL, TASE2_QUALITY,
+                TASE2_NO_TIMESTAMP, false, true);
+
+        Tase2_IndicationPoint datapointStateSupQTime
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointStateSupQTime",
+                TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL, TASE2_QUALITY,
+                TASE2_TIMESTAMP, false, true);
+
+        Tase2_IndicationPoint datapointStateSupQTimeExt
+            = Tase2_Domain_addIndicationPoint (
+                icc, "datapointStateSupQTimeExt",
+                TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL, TASE2_QUALITY,
+                TASE2_TIMESTAMP_EXTENDED, false, true);
+
+        Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointReal,
+                                           true, false);
+        Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointRealQ,
+                                           true, false);
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointRealQTime, true, false);
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointRealQTimeExt, true, false);
+
+        Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointState,
+                                           true, false);
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointStateQ, true, false);
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointStateQTime, true, false);
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointStateQTimeExt, true, false);
+
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointDiscrete, true, false);
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointDiscreteQ, true, false);
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointDiscreteQTime, true, false);
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointDiscreteQTimeExt, true, false);
+
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointStateSup, true, false);
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointStateSupQ, true, false);
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointStateSupQTime, true, false);
+        Tase2_BilateralTable_addDataPoint (
+            blt, (Tase2_DataPoint)datapointStateSupQTimeExt, true, false);
+
+        server = Tase2_Server_createEx (model, endpoint);
+
+        Tase2_Server_addBilateralTable (server, blt);
+
+        Tase2_Server_start (server);
+    }
+
+    void
+    stopServer ()
+    {
+        Tase2_Endpoint_destroy (endpoint);
+        Tase2_Server_stop (server);
+        Tase2_Server_destroy (server);
+        Tase2_DataModel_destroy (model);
+    }
+
+    bool
+    refresh (const std::string& labels)
+    {
+        PLUGIN_PARAMETER param;
+        param.name = "labels";
+        param.value = labels;
+
+        PLUGIN_PARAMETER* params[] = { &param };
+
+        return tase2->operation ("TASE2Refresh", 1, params);
+    }
+
+    /* do_value of the last reading ingested */
+    double
+    lastRealValue ()
+    {
+        Datapoint* dataObject
+            = getObject (*storedReadings.back (), "data_object");
+        return getChild (*dataObject, "do_value")->getData ().toDouble ();
+    }
+
+    bool
+    waitForIngest (int count)
+    {
+        auto timeout = std::chrono::seconds (3);
+        auto start = std::chrono::high_resolution_clock::now ();
+        while (ingestCallbackCalled < count)
+        {
+            auto now = std::chrono::high_resolution_clock::now ();
+            if (now - start > timeout)
+                return false;
+            Thread_sleep (10);
+        }
+        return true;
+    }
 };
 
 TEST_F (SpontDataTest, PollingAllType)
 {
     tase2->setJsonConfig (protocol_config, exchanged_data, tls_config);
 
-    Tase2_DataModel model = Tase2_DataModel_create ();
-
-    Tase2_Domain icc = Tase2_DataModel_addDomain (model, "icc1");
-
-    Tase2_BilateralTable blt
-        = Tase2_BilateralTable_create ("blt1", icc, "1.1.1.998", 12);
-
-    Tase2_Endpoint endpoint = Tase2_Endpoint_create (nullptr, true);
-
-    Tase2_Endpoint_setLocalIpAddress (endpoint, "0.0.0.0");
-    Tase2_Endpoint_setLocalTcpPort (endpoint, 10002);
-
-    Tase2_Endpoint_setLocalApTitle (endpoint, "1.1.1.999", 12);
-
-    Tase2_IndicationPoint datapointReal = Tase2_Domain_addIndicationPoint (
-        icc, "datapointReal", TASE2_IND_POINT_TYPE_REAL, TASE2_NO_QUALITY,
-        TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointRealQ = Tase2_Domain_addIndicationPoint (
-        icc, "datapointRealQ", TASE2_IND_POINT_TYPE_REAL, TASE2_QUALITY,
-        TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointRealQTime
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointRealQTime", TASE2_IND_POINT_TYPE_REAL,
-            TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointRealQTimeExt
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointRealQTimeExt", TASE2_IND_POINT_TYPE_REAL,
-            TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
-
-    Tase2_IndicationPoint datapointState = Tase2_Domain_addIndicationPoint (
-        icc, "datapointState", TASE2_IND_POINT_TYPE_STATE, TASE2_NO_QUALITY,
-        TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointStateQ = Tase2_Domain_addIndicationPoint (
-        icc, "datapointStateQ", TASE2_IND_POINT_TYPE_STATE, TASE2_QUALITY,
-        TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointStateQTime
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateQTime", TASE2_IND_POINT_TYPE_STATE,
-            TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointStateQTimeExt
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateQTimeExt", TASE2_IND_POINT_TYPE_STATE,
-            TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
-
-    Tase2_IndicationPoint datapointDiscrete = Tase2_Domain_addIndicationPoint (
-        icc, "datapointDiscrete", TASE2_IND_POINT_TYPE_DISCRETE,
-        TASE2_NO_QUALITY, TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointDiscreteQ
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointDiscreteQ", TASE2_IND_POINT_TYPE_DISCRETE,
-            TASE2_QUALITY, TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointDiscreteQTime
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointDiscreteQTime", TASE2_IND_POINT_TYPE_DISCRETE,
-            TASE2_QUALITY, TASE2_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointDiscreteQTimeExt
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointDiscreteQTimeExt", TASE2_IND_POINT_TYPE_DISCRETE,
-            TASE2_QUALITY, TASE2_TIMESTAMP_EXTENDED, false, true);
-
-    Tase2_IndicationPoint datapointStateSup = Tase2_Domain_addIndicationPoint (
-        icc, "datapointStateSup", TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL,
-        TASE2_NO_QUALITY, TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointStateSupQ
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateSupQ", TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL,
-            TASE2_QUALITY, TASE2_NO_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointStateSupQTime
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateSupQTime",
-            TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL, TASE2_QUALITY,
-            TASE2_TIMESTAMP, false, true);
-
-    Tase2_IndicationPoint datapointStateSupQTimeExt
-        = Tase2_Domain_addIndicationPoint (
-            icc, "datapointStateSupQTimeExt",
-            TASE2_IND_POINT_TYPE_STATE_SUPPLEMENTAL, TASE2_QUALITY,
-            TASE2_TIMESTAMP_EXTENDED, false, true);
-
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointReal,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointRealQ,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointRealQTime, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointRealQTimeExt, true, false);
-
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointState,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointStateQ,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateQTime, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateQTimeExt, true, false);
-
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointDiscrete,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointDiscreteQ, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointDiscreteQTime, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointDiscreteQTimeExt, true, false);
-
-    Tase2_BilateralTable_addDataPoint (blt, (Tase2_DataPoint)datapointStateSup,
-                                       true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateSupQ, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateSupQTime, true, false);
-    Tase2_BilateralTable_addDataPoint (
-        blt, (Tase2_DataPoint)datapointStateSupQTimeExt, true, false);
-
-    Tase2_Server server = Tase2_Server_createEx (model, endpoint);
-
-    Tase2_Server_addBilateralTable (server, blt);
-
-    Tase2_Server_start (server);
+    startServer ();
     tase2->start ();
 
     ASSERT_TRUE (tase2->m_config->m_protocolConfigComplete);
+    ASSERT_FALSE (tase2->m_config->bulkPolling ());
 
     Thread_sleep (500);
 
@@ -537,28 +673,264 @@ TEST_F (SpontDataTest, PollingAllType)
     ASSERT_TRUE (Tase2_Endpoint_getState (clientEndpoint)
                  == TASE2_ENDPOINT_STATE_CONNECTED);
 
-    auto timeout = std::chrono::seconds (3);
+    // one read per point
+    ASSERT_EQ (connection->m_pollUnits.size (), 16);
+    for (const auto& unit : connection->m_pollUnits)
+    {
+        ASSERT_EQ (unit.dataSet, nullptr);
+    }
+
+    if (!waitForIngest (16))
+    {
+        stopServer ();
+        FAIL () << "Callback not called within timeout";
+    }
+
+    ASSERT_FALSE (storedReadings.empty ());
+    ASSERT_EQ (storedReadings.size (), 16);
+
+    tase2->stop ();
+    stopServer ();
+}
+
+TEST_F (SpontDataTest, PollingAllTypeBulk)
+{
+    tase2->setJsonConfig (protocol_config_bulk, exchanged_data, tls_config);
+
+    startServer ();
+    tase2->start ();
+
+    ASSERT_TRUE (tase2->m_config->m_protocolConfigComplete);
+    ASSERT_TRUE (tase2->m_config->bulkPolling ());
+
+    Thread_sleep (500);
+
+    TASE2Client* client = tase2->m_client;
+    TASE2ClientConnection* connection = client->m_active_connection;
+    Tase2_Endpoint clientEndpoint = connection->m_endpoint;
+
+    ASSERT_TRUE (Tase2_Endpoint_getState (clientEndpoint)
+                 == TASE2_ENDPOINT_STATE_CONNECTED);
+
+    // 16 points in datasets of at most 10 members
+    ASSERT_EQ (connection->m_pollUnits.size (), 2);
+    for (const auto& unit : connection->m_pollUnits)
+    {
+        ASSERT_NE (unit.dataSet, nullptr);
+        ASSERT_LE (unit.points.size (), 10);
+        ASSERT_EQ (unit.name.find (connection->m_pollDataSetPrefix), 0);
+    }
+
+    // names of other connections and plugin instances don't collide
+    ASSERT_NE (connection->m_pollUnits[0].name,
+               connection->m_pollUnits[1].name);
+    ASSERT_NE (TASE2ClientConnection::pollDataSetPrefix (),
+               connection->m_pollDataSetPrefix);
+
+    if (!waitForIngest (16))
+    {
+        stopServer ();
+        FAIL () << "Callback not called within timeout";
+    }
+
+    ASSERT_FALSE (storedReadings.empty ());
+    ASSERT_EQ (storedReadings.size (), 16);
+
+    tase2->stop ();
+    stopServer ();
+}
+
+TEST_F (SpontDataTest, PollingFollowsConnection)
+{
+    tase2->setJsonConfig (protocol_config, exchanged_data, tls_config);
+
+    startServer ();
+    tase2->start ();
+
+    if (!waitForIngest (16))
+    {
+        stopServer ();
+        FAIL () << "Callback not called within timeout";
+    }
+
+    TASE2Client* client = tase2->m_client;
+    TASE2ClientConnection* connection = client->m_connections->front ();
+
+    // the reads are done by the poll thread of the association
+    ASSERT_NE (connection->m_pollThread, nullptr);
+    ASSERT_TRUE (connection->m_pollingEnabled);
+
+    // the connection thread sees the association end while polling goes on
+    stopServer ();
+
     auto start = std::chrono::high_resolution_clock::now ();
-    while (ingestCallbackCalled < 16)
+    while (connection->Connected ())
     {
-        auto now = std::chrono::high_resolution_clock::now ();
-        if (now - start > timeout)
+        if (std::chrono::high_resolution_clock::now () - start
+            > std::chrono::seconds (2))
         {
-            Tase2_Endpoint_destroy (endpoint);
-            Tase2_Server_stop (server);
-            Tase2_Server_destroy (server);
-            Tase2_DataModel_destroy (model);
-            FAIL () << "Callback not called within timeout";
+            FAIL () << "Disconnect not detected within timeout";
         }
         Thread_sleep (10);
     }
 
-    ASSERT_FALSE (storedReadings.empty ());
-    ASSERT_EQ (storedReadings.size (), 16);
+    // no reads without the association
+    ASSERT_FALSE (connection->m_pollingEnabled);
+
+    int count = ingestCallbackCalled;
+    Thread_sleep (1500);
+    ASSERT_EQ (ingestCallbackCalled, count);
+
+    // polling resumes with the new association
+    startServer ();
+
+    start = std::chrono::high_resolution_clock::now ();
+    while (ingestCallbackCalled < count + 16)
+    {
+        if (std::chrono::high_resolution_clock::now () - start
+            > std::chrono::seconds (10))
+        {
+            stopServer ();
+            FAIL () << "Polling not resumed within timeout";
+        }
+        Thread_sleep (10);
+    }
+
+    ASSERT_TRUE (connection->m_pollingEnabled);
+
+    tase2->stop ();
+    stopServer ();
+}
+
+TEST_F (SpontDataTest, PollingOutstandingReads)
+{
+    tase2->setJsonConfig (protocol_config_window, exchanged_data, tls_config);
+
+    startServer ();
+    tase2->start ();
+
+    ASSERT_EQ (tase2->m_config->maxOutstandingReads (), 4);
+
+    if (!waitForIngest (16))
+    {
+        stopServer ();
+        FAIL () << "Callback not called within timeout";
+    }
+
+    TASE2Client* client = tase2->m_client;
+    TASE2ClientConnection* connection = client->m_connections->front ();
+
+    // the poll thread and three workers read the 16 units
+    ASSERT_EQ (connection->m_readWorkers.size (), 3);
+    ASSERT_EQ (connection->m_pollUnits.size (), 16);
+
+    // every unit is read once per cycle
+    if (!waitForIngest (32))
+    {
+        stopServer ();
+        FAIL () << "Second poll cycle not completed within timeout";
+    }
+
+    for (const auto& stats : connection->m_pollCycles)
+    {
+        ASSERT_GE (stats.cycles, 1);
+        ASSERT_EQ (stats.overruns, 0);
+    }
+
+    tase2->stop ();
+    stopServer ();
+}
+
+TEST_F (SpontDataTest, Refresh)
+{
+    tase2->setJsonConfig (protocol_config_refresh, exchanged_data, tls_config);
+
+    startServer ();
+    tase2->start ();
+
+    ASSERT_TRUE (tase2->m_config->m_protocolConfigComplete);
+
+    // the first poll is right after connecting, the next one in a minute
+    if (!waitForIngest (16))
+    {
+        stopServer ();
+        FAIL () << "Callback not called within timeout";
+    }
+
+    TASE2Client* client = tase2->m_client;
+    TASE2ClientConnection* connection = client->m_active_connection;
+
+    ASSERT_TRUE (Tase2_Endpoint_getState (connection->m_endpoint)
+                 == TASE2_ENDPOINT_STATE_CONNECTED);
+
+    Tase2_IndicationPoint_setReal (datapointReal, 12.5f);
+    Tase2_Server_updateOnlineValue (server, (Tase2_DataPoint)datapointReal);
+
+    // within refresh_ttl of the poll -> the cached value, read before the
+    // change
+    ASSERT_TRUE (refresh ("TS3"));
+    ASSERT_TRUE (waitForIngest (17));
+    ASSERT_EQ (storedReadings.back ()->getAssetName (), "TS3");
+    ASSERT_NEAR (lastRealValue (), 0.0, 0.0001);
+
+    Thread_sleep (1100);
+
+    // the cached value is too old -> read again
+    ASSERT_TRUE (refresh ("TS3"));
+    ASSERT_TRUE (waitForIngest (18));
+    ASSERT_EQ (storedReadings.back ()->getAssetName (), "TS3");
+    ASSERT_NEAR (lastRealValue (), 12.5, 0.0001);
+
+    // nothing else was read
+    Thread_sleep (200);
+    ASSERT_EQ (ingestCallbackCalled, 18);
+
+    ASSERT_FALSE (refresh ("unknown"));
 
     tase2->stop ();
-    Tase2_Endpoint_destroy (endpoint);
-    Tase2_Server_stop (server);
-    Tase2_Server_destroy (server);
-    Tase2_DataModel_destroy (model);
+    stopServer ();
+}
+
+TEST_F (SpontDataTest, RefreshParameters)
+{
+    auto parse = [] (const std::string& name, const std::string& value,
+                     std::vector<std::string>& labels, std::string& domain) {
+        PLUGIN_PARAMETER param;
+        param.name = name;
+        param.value = value;
+
+        PLUGIN_PARAMETER* params[] = { &param };
+
+        labels.clear ();
+        domain.clear ();
+        TASE2::m_parseRefreshParameters (1, params, labels, domain);
+    };
+
+    std::vector<std::string> labels;
+    std::string domain;
+
+    parse ("labels", "TS1,TS2", labels, domain);
+    ASSERT_EQ (labels, std::vector<std::string> ({ "TS1", "TS2" }));
+    ASSERT_TRUE (domain.empty ());
+
+    parse ("labels", " TS1 ,\tTS2 , , TS3 ", labels, domain);
+    ASSERT_EQ (labels, std::vector<std::string> ({ "TS1", "TS2", "TS3" }));
+
+    // the whole list or each label quoted
+    parse ("labels", "\"TS1, TS2\"", labels, domain);
+    ASSERT_EQ (labels, std::vector<std::string> ({ "TS1", "TS2" }));
+
+    parse ("labels", "\"TS1\", \"TS2\"", labels, domain);
+    ASSERT_EQ (labels, std::vector<std::string> ({ "TS1", "TS2" }));
+
+    // no labels, all points are read
+    parse ("labels", "", labels, domain);
+    ASSERT_TRUE (labels.empty ());
+
+    parse ("labels", "\"\"", labels, domain);
+    ASSERT_TRUE (labels.empty ());
+
+    parse ("domain", "\"icc1\"", labels, domain);
+    ASSERT_TRUE (labels.empty ());
+    ASSERT_EQ (domain, "icc1");
 }
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <tase2_timing_wheel.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+TEST (TimingWheelTest, ExpireInOrder)
+{
+    TimingWheel wheel (10);
+    wheel.reset (1000);
+
+    wheel.schedule (1, 1050);
+    wheel.schedule (2, 1500);
+    wheel.schedule (3, 1000); // overdue, expires with the next tick
+
+    vector<uint32_t> expired;
+
+    wheel.advance (1010, expired);
+    ASSERT_EQ (vector<uint32_t> ({ 3 }), expired);
+
+    expired.clear ();
+    wheel.advance (1040, expired);
+    ASSERT_TRUE (expired.empty ());
+
+    wheel.advance (1050, expired);
+    ASSERT_EQ (vector<uint32_t> ({ 1 }), expired);
+
+    expired.clear ();
+    wheel.advance (1499, expired);
+    ASSERT_TRUE (expired.empty ());
+
+    wheel.advance (1500, expired);
+    ASSERT_EQ (vector<uint32_t> ({ 2 }), expired);
+    ASSERT_EQ (0, wheel.size ());
+}
+
+TEST (TimingWheelTest, LongIntervals)
+{
+    TimingWheel wheel (10);
+    wheel.reset (0);
+
+    // needs cascading from the higher levels
+    wheel.schedule (1, 3600000);
+    // beyond the range of the wheel
+    wheel.schedule (2, 200000000ULL);
+
+    vector<uint32_t> expired;
+
+    wheel.advance (3599990, expired);
+    ASSERT_TRUE (expired.empty ());
+
+    wheel.advance (3600000, expired);
+    ASSERT_EQ (vector<uint32_t> ({ 1 }), expired);
+
+    expired.clear ();
+    wheel.advance (199999990ULL, expired);
+    ASSERT_TRUE (expired.empty ());
+
+    wheel.advance (200000000ULL, expired);
+    ASSERT_EQ (vector<uint32_t> ({ 2 }), expired);
+}
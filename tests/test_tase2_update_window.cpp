@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <tase2_update_window.hpp>
+
+#include <vector>
+
+using namespace std;
+
+static PointUpdate
+makeUpdate (const DataExchangeDefinition* def, int64_t value,
+            Tase2_DataFlags flags = 0)
+{
+    PointUpdate update;
+    update.def = def;
+    update.intValue = value;
+    update.flags = flags;
+    return update;
+}
+
+static vector<int64_t>
+values (const UpdateWindows::Output& out)
+{
+    vector<int64_t> result;
+
+    for (const auto& windowed : out)
+        result.push_back (windowed.update.intValue);
+
+    return result;
+}
+
+TEST (UpdateWindowTest, CoalesceLatest)
+{
+    DataExchangeDefinition def;
+    def.id = 0;
+    def.coalesceWindow = 100;
+
+    DataExchangeDefinition other;
+    other.id = 1;
+
+    UpdateWindows windows;
+    windows.reset (2);
+    UpdateWindows::Output out;
+
+    windows.add (makeUpdate (&def, 1), 1000, out);
+    windows.add (makeUpdate (&def, 2), 1010, out);
+    windows.add (makeUpdate (&def, 3), 1050, out);
+
+    // points without a window are passed on right away
+    windows.add (makeUpdate (&other, 42), 1050, out);
+    ASSERT_EQ (values (out), vector<int64_t> ({ 42 }));
+    out.clear ();
+
+    ASSERT_EQ (windows.nextDeadline (), 1100);
+
+    windows.expire (1099, out);
+    ASSERT_TRUE (out.empty ());
+
+    windows.expire (1100, out);
+    ASSERT_EQ (values (out), vector<int64_t> ({ 3 }));
+    ASSERT_EQ (windows.nextDeadline (), 0);
+    out.clear ();
+
+    // a quality change closes the window and is not held back
+    windows.add (makeUpdate (&def, 4), 1200, out);
+    windows.add (makeUpdate (&def, 5, TASE2_DATA_FLAGS_VALIDITY_SUSPECT), 1210,
+                 out);
+    ASSERT_EQ (values (out), vector<int64_t> ({ 4, 5 }));
+    out.clear ();
+
+    windows.expire (1300, out);
+    ASSERT_TRUE (out.empty ());
+
+    windows.add (makeUpdate (&def, 6, TASE2_DATA_FLAGS_VALIDITY_SUSPECT), 1400,
+                 out);
+    windows.flush (out);
+    ASSERT_EQ (values (out), vector<int64_t> ({ 6 }));
+}
+
+TEST (UpdateWindowTest, CoalesceFirstLast)
+{
+    DataExchangeDefinition def;
+    def.id = 0;
+    def.coalesceWindow = 100;
+    def.coalesceMode = CoalesceMode::FIRST_LAST;
+
+    UpdateWindows windows;
+    windows.reset (1);
+    UpdateWindows::Output out;
+
+    windows.add (makeUpdate (&def, 1), 1000, out);
+    ASSERT_EQ (values (out), vector<int64_t> ({ 1 }));
+
+    windows.add (makeUpdate (&def, 0), 1020, out);
+    windows.add (makeUpdate (&def, 1), 1040, out);
+    windows.add (makeUpdate (&def, 0), 1060, out);
+    windows.expire (1100, out);
+
+    ASSERT_EQ (values (out), vector<int64_t> ({ 1, 0 }));
+    out.clear ();
+
+    // a single update in a window is only ingested once
+    windows.add (makeUpdate (&def, 1), 2000, out);
+    windows.expire (2100, out);
+    ASSERT_EQ (values (out), vector<int64_t> ({ 1 }));
+}
+
+TEST (UpdateWindowTest, Aggregate)
+{
+    DataExchangeDefinition def;
+    def.id = 0;
+    def.aggregateWindow = 10000;
+
+    UpdateWindows windows;
+    windows.reset (1);
+    UpdateWindows::Output out;
+
+    const double samples[] = { 4.0, 1.0, 7.0, 2.0 };
+    uint64_t now = 1000;
+
+    for (double sample : samples)
+    {
+        PointUpdate update;
+        update.def = &def;
+        update.realValue = sample;
+        windows.add (update, now, out);
+        now += 1000;
+    }
+
+    ASSERT_TRUE (out.empty ());
+
+    windows.expire (11000, out);
+    ASSERT_EQ (out.size (), 1);
+    ASSERT_TRUE (out[0].aggregate);
+    ASSERT_EQ (out[0].update.realValue, 2.0);
+    ASSERT_EQ (out[0].stats.min, 1.0);
+    ASSERT_EQ (out[0].stats.max, 7.0);
+    ASSERT_EQ (out[0].stats.sum, 14.0);
+    ASSERT_EQ (out[0].stats.count, 4);
+    out.clear ();
+
+    // a quality change ends the aggregation window
+    PointUpdate update;
+    update.def = &def;
+    update.realValue = 3.0;
+    windows.add (update, 12000, out);
+    update.flags = TASE2_DATA_FLAGS_VALIDITY_SUSPECT;
+    update.realValue = 5.0;
+    windows.add (update, 13000, out);
+    ASSERT_EQ (out.size (), 1);
+    ASSERT_EQ (out[0].stats.count, 1);
+    ASSERT_EQ (out[0].update.realValue, 3.0);
+
+    windows.flush (out);
+    ASSERT_EQ (out.size (), 2);
+    ASSERT_EQ (out[1].update.realValue, 5.0);
+    ASSERT_EQ (out[1].stats.count, 1);
+}